@@ -44,6 +44,13 @@ class Graph {
           color(_color) {}
   };
 
+  Graph() = default;
+  // graphs are handed over by move only
+  Graph(const Graph&) = delete;
+  Graph& operator=(const Graph&) = delete;
+  Graph(Graph&&) = default;
+  Graph& operator=(Graph&&) = default;
+
   VertexId add_vertex();
 
   void add_edge(const VertexId& from_vertex_id, const VertexId& to_vertex_id);
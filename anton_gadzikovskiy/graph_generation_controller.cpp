@@ -26,7 +26,7 @@ void GraphGenerationController::generate(
         const lock_guard lock(gen_started_mutex);
         gen_started_callback(i);
       }
-      const auto graph = generator.generate();
+      auto graph = generator.generate();
       {
         const lock_guard lock(gen_finished_mutex);
         gen_finished_callback(i, std::move(graph));
@@ -13,7 +13,7 @@ class GraphGenerationController {
  public:
   using JobCallback = std::function<void()>;
   using GenStartedCallback = std::function<void(int)>;
-  using GenFinishedCallback = std::function<void(int, Graph)>;
+  using GenFinishedCallback = std::function<void(int, Graph&&)>;
 
   class Worker {
    public:
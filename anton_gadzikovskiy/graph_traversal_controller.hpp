@@ -47,7 +47,7 @@ class GraphTraversalController {
   std::list<Worker> workers_;
   std::list<JobCallback> jobs_;
   std::mutex jobs_mutex_;
-  std::vector<Graph> graphs_;
+  const std::vector<Graph>& graphs_;
 };
 
 }  // namespace uni_cource_cpp
@@ -91,16 +91,16 @@ std::vector<Graph> generate_graphs(const GraphGenerator::Params& params,
 
   generation_controller.generate(
       [&logger](int index) { logger.log(generation_started_string(index)); },
-      [&logger, &graphs](int index, Graph graph) {
+      [&logger, &graphs](int index, Graph&& graph) {
         const auto graph_description =
             uni_cource_cpp::graph_printing::print_graph_description(graph);
         logger.log(generation_finished_string(index, graph_description));
-        graphs.push_back(graph);
         const auto graph_json =
             uni_cource_cpp::graph_printing::print_graph(graph);
         write_to_file(graph_json,
                       string(uni_cource_cpp::config::kTempDirectoryPath) +
                           "graph_" + to_string(index) + ".json");
+        graphs.push_back(std::move(graph));
       });
 
   return graphs;
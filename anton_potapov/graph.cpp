@@ -124,6 +124,48 @@ const std::set<EdgeId>& Graph::edge_ids_with_color(
   return result;
 }
 
+std::pair<VertexId, EdgeId> Graph::reserve_gray_branches(int count) {
+  const auto first_ids = std::make_pair(next_vertex_id_, next_edge_id_);
+  next_vertex_id_ += count;
+  next_edge_id_ += count;
+  return first_ids;
+}
+
+void Graph::build_gray_branch(const VertexId& parent_id,
+                              const VertexId& vertex_id,
+                              const EdgeId& edge_id,
+                              GrayBranches& branches) {
+  assert(is_vertex_exists(parent_id) && "Parent vertex doesn't exist");
+  // ids are built in ascending order, so every node goes to the end
+  branches.edges.emplace_hint(branches.edges.end(), edge_id,
+                              Edge(edge_id, parent_id, vertex_id,
+                                   EdgeColor::Gray));
+  branches.edge_ids.insert(branches.edge_ids.end(), edge_id);
+  branches.vertices.emplace_hint(branches.vertices.end(), vertex_id, vertex_id)
+      ->second.add_edge(edge_id);
+  vertices_.find(parent_id)->second.add_edge(edge_id);
+}
+
+void Graph::attach_gray_branches(GrayBranches& branches) {
+  // the reserved ids are above all existing ones, the hint makes every
+  // insertion amortized constant
+  while (!branches.vertices.empty()) {
+    vertices_.insert(vertices_.end(),
+                     branches.vertices.extract(branches.vertices.begin()));
+  }
+  while (!branches.edges.empty()) {
+    edges_.insert(edges_.end(), branches.edges.extract(branches.edges.begin()));
+  }
+  auto& gray_edge_ids = edge_color_map_[EdgeColor::Gray];
+  while (!branches.edge_ids.empty()) {
+    gray_edge_ids.insert(gray_edge_ids.end(),
+                         branches.edge_ids.extract(branches.edge_ids.begin()));
+  }
+  // depths of the new vertices are found by a full update, as after add_edge
+  is_depth_dirty_ = true;
+  updated_depth_ = INIT_DEPTH;
+}
+
 VertexId Graph::get_next_vertex_id() {
   return next_vertex_id_++;
 }
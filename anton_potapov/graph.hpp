@@ -4,6 +4,7 @@
 #include <set>
 #include <string>
 #include <unordered_map>
+#include <utility>
 
 namespace uni_cource_cpp {
 using VertexId = int;
@@ -44,6 +45,14 @@ class Edge {
 
 class Graph {
  public:
+  // new vertices joined to their parents by gray edges, built apart from the
+  // graph so that slices of a level can be filled by several threads at once
+  struct GrayBranches {
+    std::map<VertexId, Vertex> vertices;
+    std::map<EdgeId, Edge> edges;
+    std::set<EdgeId> edge_ids;
+  };
+
   Vertex& get_vertex(const VertexId& id);
 
   const Edge& get_edge(const EdgeId& id) const;
@@ -72,6 +81,21 @@ class Graph {
   const std::set<EdgeId>& edge_ids_with_color(
       const EdgeColor& edge_color) const;
 
+  // takes count consecutive vertex ids and as many edge ids for gray
+  // branches, returns the first id of each range
+  std::pair<VertexId, EdgeId> reserve_gray_branches(int count);
+
+  // adds the vertex and its gray edge from the parent to branches. Safe to
+  // call from several threads as long as they use distinct parents and
+  // branches and nothing else changes the graph meanwhile
+  void build_gray_branch(const VertexId& parent_id,
+                         const VertexId& vertex_id,
+                         const EdgeId& edge_id,
+                         GrayBranches& branches);
+
+  // moves the built vertices and edges into the graph without copying them
+  void attach_gray_branches(GrayBranches& branches);
+
   const VertexId& get_root_vertex_id() const;
 
  private:
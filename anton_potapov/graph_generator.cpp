@@ -1,10 +1,14 @@
+#include <algorithm>
 #include <cassert>
+#include <functional>
 #include <iterator>
 #include <limits>
 #include <map>
 #include <random>
 #include <set>
+#include <thread>
 #include <utility>
+#include <vector>
 
 #include "graph.hpp"
 #include "graph_generator.hpp"
@@ -30,22 +34,106 @@ bool is_lucky(float probability) {
   return bernoullu_distribution_var(rng);
 }
 
+// levels narrower than this are processed by a single thread, since spawning
+// threads costs more than deciding a few hundred branchings
+constexpr size_t MIN_VERTICES_PER_THREAD = 1024;
+
+size_t get_level_threads_count(size_t level_size) {
+  const size_t max_threads_count =
+      std::max(1u, std::thread::hardware_concurrency());
+  return std::clamp<size_t>(level_size / MIN_VERTICES_PER_THREAD, 1,
+                            max_threads_count);
+}
+
+// splits [0, size) into threads_count contiguous slices and runs
+// slice_job(slice_index, begin, end) for each of them in its own thread
+void for_each_slice(
+    size_t size,
+    size_t threads_count,
+    const std::function<void(size_t, size_t, size_t)>& slice_job) {
+  const size_t slice_size = (size + threads_count - 1) / threads_count;
+  if (threads_count == 1) {
+    slice_job(0, 0, size);
+    return;
+  }
+  std::vector<std::thread> threads;
+  threads.reserve(threads_count);
+  for (size_t slice_index = 0; slice_index < threads_count; ++slice_index) {
+    const size_t begin = std::min(size, slice_index * slice_size);
+    const size_t end = std::min(size, begin + slice_size);
+    threads.emplace_back(slice_job, slice_index, begin, end);
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+}
+
+// builds the gray tree level by level: every thread decides children counts
+// for its slice of the current level, a prefix sum over the counts assigns
+// contiguous ids to the children of each parent, and every thread then builds
+// the vertices and gray edges of its slice, which are attached in one pass
 void generate_vertices(Graph& graph, int depth, int new_vertices_num) {
-  graph.add_vertex();
-  for (int current_depth = 0;
-       current_depth <= graph.depth() && current_depth < depth;
+  std::vector<VertexId> current_level = {graph.add_vertex()};
+  static std::knuth_b seed_engine{};
+  for (int current_depth = 0; current_depth < depth && !current_level.empty();
        ++current_depth) {
-    // copy is needed since get_vertices_at_depth() returns a const reference to
-    // a changing object
-    const auto same_depth_vertices = graph.get_vertices_at_depth(current_depth);
-    for (const auto& current_vertex_id : same_depth_vertices) {
-      for (int i = 0; i < new_vertices_num; ++i) {
-        if (depth > 0 && is_lucky(1.0 - (float)current_depth / depth)) {
-          const VertexId new_vertex_id = graph.add_vertex();
-          graph.add_edge(current_vertex_id, new_vertex_id);
-        }
-      }
+    const float probability = 1.0 - (float)current_depth / depth;
+    const size_t threads_count = get_level_threads_count(current_level.size());
+    const auto level_seed = seed_engine();
+
+    std::vector<int> children_counts(current_level.size());
+    std::vector<size_t> slice_children_counts(threads_count, 0);
+    for_each_slice(current_level.size(), threads_count,
+                   [&](size_t slice_index, size_t begin, size_t end) {
+                     std::mt19937 rng{level_seed + slice_index};
+                     std::bernoulli_distribution is_lucky(probability);
+                     size_t slice_children_count = 0;
+                     for (size_t i = begin; i < end; ++i) {
+                       int children_count = 0;
+                       for (int j = 0; j < new_vertices_num; ++j) {
+                         children_count += is_lucky(rng);
+                       }
+                       children_counts[i] = children_count;
+                       slice_children_count += children_count;
+                     }
+                     slice_children_counts[slice_index] = slice_children_count;
+                   });
+
+    // exclusive scan over the slice totals is serial, it is threads_count long
+    std::vector<size_t> slice_offsets(threads_count, 0);
+    for (size_t slice_index = 1; slice_index < threads_count; ++slice_index) {
+      slice_offsets[slice_index] = slice_offsets[slice_index - 1] +
+                                   slice_children_counts[slice_index - 1];
+    }
+    const size_t next_level_size =
+        slice_offsets.back() + slice_children_counts.back();
+
+    // ids come out contiguous and ordered by depth, the slices of a level
+    // have disjoint parents, so they build their branches without locks
+    const auto [first_vertex_id, first_edge_id] =
+        graph.reserve_gray_branches(static_cast<int>(next_level_size));
+    std::vector<VertexId> next_level(next_level_size);
+    std::vector<Graph::GrayBranches> slice_branches(threads_count);
+    for_each_slice(current_level.size(), threads_count,
+                   [&](size_t slice_index, size_t begin, size_t end) {
+                     auto& branches = slice_branches[slice_index];
+                     size_t offset = slice_offsets[slice_index];
+                     for (size_t i = begin; i < end; ++i) {
+                       for (int j = 0; j < children_counts[i]; ++j) {
+                         next_level[offset] = first_vertex_id + offset;
+                         graph.build_gray_branch(current_level[i],
+                                                 next_level[offset],
+                                                 first_edge_id + offset,
+                                                 branches);
+                         ++offset;
+                       }
+                     }
+                   });
+
+    for (auto& branches : slice_branches) {
+      graph.attach_gray_branches(branches);
     }
+    current_level = std::move(next_level);
   }
 }
 
@@ -0,0 +1,57 @@
+#include <optional>
+#include <vector>
+
+#include "../../anton_gadzikovskiy/graph.hpp"
+#include "../../anton_gadzikovskiy/graph_generator.hpp"
+#include "../../anton_gadzikovskiy/graph_traverser.hpp"
+#include "../input_graph.hpp"
+#include "engine.hpp"
+
+namespace {
+
+using uni_cource_cpp::Graph;
+using uni_cource_cpp::GraphGenerator;
+using uni_cource_cpp::GraphTraverser;
+
+std::optional<Graph> loaded_graph;
+
+}  // namespace
+
+namespace engine_harness {
+
+namespace engine {
+
+std::vector<EdgeColor> get_colors() {
+  return {EdgeColor::Gray, EdgeColor::Green, EdgeColor::Yellow,
+          EdgeColor::Red};
+}
+
+GeneratedGraph generate(int depth, int new_vertices_count) {
+  const auto graph =
+      GraphGenerator(GraphGenerator::Params(depth, new_vertices_count))
+          .generate();
+  return {graph.get_vertices_amount(), graph.get_edges_amount()};
+}
+
+void load(const InputGraph& input_graph) {
+  auto& graph = loaded_graph.emplace();
+  for (int vertex_id = 0; vertex_id < input_graph.parent_vertex_ids.size();
+       vertex_id++) {
+    graph.add_vertex();
+    if (input_graph.parent_vertex_ids[vertex_id] >= 0)
+      graph.add_edge(input_graph.parent_vertex_ids[vertex_id], vertex_id);
+  }
+  for (const auto& edge : input_graph.colored_edges)
+    graph.add_edge(edge.from_vertex_id, edge.to_vertex_id);
+}
+
+std::vector<int> traverse() {
+  std::vector<int> distances;
+  for (const auto& path : GraphTraverser(*loaded_graph).find_all_paths())
+    distances.push_back(path.distance());
+  return distances;
+}
+
+}  // namespace engine
+
+}  // namespace engine_harness
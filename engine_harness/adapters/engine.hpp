@@ -0,0 +1,33 @@
+#pragma once
+
+#include <vector>
+
+#include "../input_graph.hpp"
+
+namespace engine_harness {
+
+// implemented once per engine in adapters/<engine>.cpp and linked with that
+// engine's sources, so every engine keeps its own names and namespaces
+namespace engine {
+
+struct GeneratedGraph {
+  int vertices_count = 0;
+  int edges_count = 0;
+};
+
+// edge colors the engine tells apart, edges of other colors cant be loaded
+std::vector<EdgeColor> get_colors();
+
+// runs the engine's own generator
+GeneratedGraph generate(int depth, int new_vertices_count);
+
+// builds the engine graph from the input, it stays loaded for traverse()
+void load(const InputGraph& graph);
+
+// distances of the paths the engine finds from the root to every vertex at
+// the greatest depth of the loaded graph
+std::vector<int> traverse();
+
+}  // namespace engine
+
+}  // namespace engine_harness
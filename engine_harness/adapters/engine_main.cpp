@@ -0,0 +1,102 @@
+// common entry point of the engine binaries the harness runs:
+//
+//   <engine> colors
+//   <engine> generate <depth> <new_vertices> <repetitions>
+//   <engine> traverse <input graph file> <repetitions>
+//
+// results are printed as "key value..." lines
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "../input_graph.hpp"
+#include "engine.hpp"
+
+namespace {
+
+namespace engine = engine_harness::engine;
+
+double measure_seconds(const std::function<void()>& job) {
+  const auto start = std::chrono::steady_clock::now();
+  job();
+  const std::chrono::duration<double> duration =
+      std::chrono::steady_clock::now() - start;
+  return duration.count();
+}
+
+template <typename T>
+void print_line(const std::string& key, const std::vector<T>& values) {
+  std::cout << key;
+  for (const auto& value : values)
+    std::cout << " " << value;
+  std::cout << "\n";
+}
+
+void print_colors() {
+  std::vector<std::string> names;
+  for (const auto& color : engine::get_colors())
+    names.push_back(engine_harness::color_to_string(color));
+  print_line("colors", names);
+}
+
+void run_generate(int depth, int new_vertices_count, int repetitions) {
+  std::vector<double> seconds;
+  std::vector<int> vertices_counts;
+  std::vector<int> edges_counts;
+  for (int repetition = 0; repetition < repetitions; repetition++) {
+    engine::GeneratedGraph graph;
+    seconds.push_back(measure_seconds([&graph, depth, new_vertices_count]() {
+      graph = engine::generate(depth, new_vertices_count);
+    }));
+    vertices_counts.push_back(graph.vertices_count);
+    edges_counts.push_back(graph.edges_count);
+  }
+  print_line("seconds", seconds);
+  print_line("vertices", vertices_counts);
+  print_line("edges", edges_counts);
+}
+
+void run_traverse(const std::string& input_path, int repetitions) {
+  std::ifstream input(input_path);
+  const auto graph = engine_harness::read_input_graph(input);
+  std::vector<double> load_seconds;
+  std::vector<double> traverse_seconds;
+  std::vector<int> distances;
+  for (int repetition = 0; repetition < repetitions; repetition++) {
+    load_seconds.push_back(
+        measure_seconds([&graph]() { engine::load(graph); }));
+    traverse_seconds.push_back(
+        measure_seconds([&distances]() { distances = engine::traverse(); }));
+  }
+  std::sort(distances.begin(), distances.end());
+  print_line("load_seconds", load_seconds);
+  print_line("traverse_seconds", traverse_seconds);
+  print_line("distances", distances);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  const std::vector<std::string> args(argv + 1, argv + argc);
+  try {
+    if (args.size() == 1 && args[0] == "colors") {
+      print_colors();
+    } else if (args.size() == 4 && args[0] == "generate") {
+      run_generate(std::stoi(args[1]), std::stoi(args[2]),
+                   std::stoi(args[3]));
+    } else if (args.size() == 3 && args[0] == "traverse") {
+      run_traverse(args[1], std::stoi(args[2]));
+    } else {
+      std::cerr << "Unknown command" << std::endl;
+      return 1;
+    }
+  } catch (const std::exception& exception) {
+    std::cerr << exception.what() << std::endl;
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,58 @@
+#include <optional>
+#include <vector>
+
+#include "../../nikolai_chernyshov/graph.hpp"
+#include "../../nikolai_chernyshov/graph_generator.hpp"
+#include "../../nikolai_chernyshov/graph_traverser.hpp"
+#include "../input_graph.hpp"
+#include "engine.hpp"
+
+namespace {
+
+using uni_course_cpp::Graph;
+using uni_course_cpp::GraphGenerator;
+using uni_course_cpp::GraphTraverser;
+
+std::optional<Graph> loaded_graph;
+
+}  // namespace
+
+namespace engine_harness {
+
+namespace engine {
+
+std::vector<EdgeColor> get_colors() {
+  return {EdgeColor::Gray, EdgeColor::Green, EdgeColor::Yellow,
+          EdgeColor::Red};
+}
+
+GeneratedGraph generate(int depth, int new_vertices_count) {
+  const auto graph =
+      GraphGenerator(GraphGenerator::Params(depth, new_vertices_count))
+          .generate();
+  return {static_cast<int>(graph.get_vertices().size()),
+          static_cast<int>(graph.get_edges().size())};
+}
+
+void load(const InputGraph& input_graph) {
+  auto& graph = loaded_graph.emplace();
+  for (int vertex_id = 0; vertex_id < input_graph.parent_vertex_ids.size();
+       vertex_id++) {
+    graph.add_vertex();
+    if (input_graph.parent_vertex_ids[vertex_id] >= 0)
+      graph.add_edge(input_graph.parent_vertex_ids[vertex_id], vertex_id);
+  }
+  for (const auto& edge : input_graph.colored_edges)
+    graph.add_edge(edge.from_vertex_id, edge.to_vertex_id);
+}
+
+std::vector<int> traverse() {
+  std::vector<int> distances;
+  for (const auto& path : GraphTraverser(*loaded_graph).find_all_paths())
+    distances.push_back(path.distance());
+  return distances;
+}
+
+}  // namespace engine
+
+}  // namespace engine_harness
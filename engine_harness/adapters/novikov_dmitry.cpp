@@ -0,0 +1,66 @@
+#include <optional>
+#include <vector>
+
+#include "../../novikov_dmitry/graph.hpp"
+#include "../../novikov_dmitry/graph_generator.hpp"
+#include "../../novikov_dmitry/graph_traverser.hpp"
+#include "../input_graph.hpp"
+#include "engine.hpp"
+
+namespace {
+
+using uni_cpp_practice::Edge;
+using uni_cpp_practice::Graph;
+using uni_cpp_practice::GraphGenerator;
+using uni_cpp_practice::GraphTraverser;
+
+std::optional<Graph> loaded_graph;
+
+// the engine takes the edge color from the caller, both enums share the order
+Edge::Color to_engine_color(engine_harness::EdgeColor color) {
+  return static_cast<Edge::Color>(color);
+}
+
+}  // namespace
+
+namespace engine_harness {
+
+namespace engine {
+
+std::vector<EdgeColor> get_colors() {
+  return {EdgeColor::Gray, EdgeColor::Green, EdgeColor::Blue,
+          EdgeColor::Yellow, EdgeColor::Red};
+}
+
+GeneratedGraph generate(int depth, int new_vertices_count) {
+  const auto graph =
+      GraphGenerator(GraphGenerator::Params(depth, new_vertices_count))
+          .generate();
+  return {static_cast<int>(graph.get_vertex_map().size()),
+          static_cast<int>(graph.get_edge_map().size())};
+}
+
+void load(const InputGraph& input_graph) {
+  auto& graph = loaded_graph.emplace();
+  for (int vertex_id = 0; vertex_id < input_graph.parent_vertex_ids.size();
+       vertex_id++) {
+    graph.add_vertex();
+    if (input_graph.parent_vertex_ids[vertex_id] >= 0)
+      graph.add_edge(input_graph.parent_vertex_ids[vertex_id], vertex_id,
+                     Edge::Color::Gray);
+  }
+  for (const auto& edge : input_graph.colored_edges)
+    graph.add_edge(edge.from_vertex_id, edge.to_vertex_id,
+                   to_engine_color(edge.color));
+}
+
+std::vector<int> traverse() {
+  std::vector<int> distances;
+  for (const auto& path : GraphTraverser(*loaded_graph).find_all_paths())
+    distances.push_back(path.distance);
+  return distances;
+}
+
+}  // namespace engine
+
+}  // namespace engine_harness
@@ -0,0 +1,63 @@
+#include <optional>
+#include <vector>
+
+#include "../../roman_kuprii/graph.hpp"
+#include "../../roman_kuprii/graph_generator.hpp"
+#include "../../roman_kuprii/graph_snapshot.hpp"
+#include "../../roman_kuprii/graph_traverser.hpp"
+#include "../input_graph.hpp"
+#include "engine.hpp"
+
+namespace {
+
+using uni_cpp_practice::Graph;
+using uni_cpp_practice::GraphGenerator;
+using uni_cpp_practice::GraphSnapshot;
+using uni_cpp_practice::GraphTraverser;
+
+std::optional<GraphSnapshot> loaded_graph;
+
+}  // namespace
+
+namespace engine_harness {
+
+namespace engine {
+
+std::vector<EdgeColor> get_colors() {
+  return {EdgeColor::Gray, EdgeColor::Green, EdgeColor::Blue,
+          EdgeColor::Yellow, EdgeColor::Red};
+}
+
+GeneratedGraph generate(int depth, int new_vertices_count) {
+  const auto graph =
+      GraphGenerator(GraphGenerator::Params(depth, new_vertices_count))
+          .generate();
+  return {static_cast<int>(graph.get_vertices().size()),
+          static_cast<int>(graph.get_edges().size())};
+}
+
+void load(const InputGraph& input_graph) {
+  Graph graph;
+  for (int vertex_id = 0; vertex_id < input_graph.parent_vertex_ids.size();
+       vertex_id++) {
+    graph.add_vertex();
+    if (input_graph.parent_vertex_ids[vertex_id] >= 0)
+      graph.connect_vertices(input_graph.parent_vertex_ids[vertex_id],
+                             vertex_id);
+  }
+  for (const auto& edge : input_graph.colored_edges)
+    graph.connect_vertices(edge.from_vertex_id, edge.to_vertex_id);
+  // the engine traverses frozen snapshots
+  loaded_graph = GraphSnapshot::freeze(graph);
+}
+
+std::vector<int> traverse() {
+  std::vector<int> distances;
+  for (const auto& path : GraphTraverser(*loaded_graph).traverse_graph())
+    distances.push_back(path.distance);
+  return distances;
+}
+
+}  // namespace engine
+
+}  // namespace engine_harness
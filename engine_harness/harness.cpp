@@ -0,0 +1,330 @@
+// benchmarks the engine binaries built by the Makefile on one seeded graph and
+// checks their traversals agree.
+//
+//   harness --engines build/roman_kuprii,build/tevfik_aksoy --depth 6
+//           --new_vertices 3 --seed 1 --repetitions 5 [--output result.json]
+//
+// every engine generates graphs with its own generator, then loads and
+// traverses the same input graph, restricted to the colors all of them know
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <queue>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "input_graph.hpp"
+
+namespace {
+
+using engine_harness::EdgeColor;
+using engine_harness::InputGraph;
+
+// "key value..." lines an engine printed
+using EngineOutput = std::map<std::string, std::vector<std::string>>;
+
+struct Options {
+  std::vector<std::string> engine_paths;
+  int depth = 4;
+  int new_vertices_count = 3;
+  int seed = 1;
+  int repetitions = 5;
+  std::string output_path;
+};
+
+std::vector<std::string> split(const std::string& text, char separator) {
+  std::vector<std::string> parts;
+  std::stringstream stream(text);
+  std::string part;
+  while (std::getline(stream, part, separator))
+    if (!part.empty())
+      parts.push_back(part);
+  return parts;
+}
+
+Options parse_options(int argc, char** argv) {
+  Options options;
+  for (int i = 1; i < argc; i += 2) {
+    const std::string flag = argv[i];
+    if (flag.rfind("--", 0) != 0 || i + 1 == argc)
+      throw std::invalid_argument("Expected '--key value', got '" + flag +
+                                  "'");
+    const std::string key = flag.substr(2);
+    const std::string value = argv[i + 1];
+    if (key == "engines")
+      options.engine_paths = split(value, ',');
+    else if (key == "depth")
+      options.depth = std::stoi(value);
+    else if (key == "new_vertices")
+      options.new_vertices_count = std::stoi(value);
+    else if (key == "seed")
+      options.seed = std::stoi(value);
+    else if (key == "repetitions")
+      options.repetitions = std::stoi(value);
+    else if (key == "output")
+      options.output_path = value;
+    else
+      throw std::invalid_argument("Unknown parameter '" + key + "'");
+  }
+  if (options.engine_paths.empty())
+    throw std::invalid_argument("No engines given");
+  if (options.repetitions < 1)
+    throw std::invalid_argument("Need at least one repetition");
+  return options;
+}
+
+EngineOutput run_engine(const std::string& engine_path,
+                        const std::string& arguments) {
+  const std::string command = engine_path + " " + arguments;
+  const auto pipe_closer = [](FILE* pipe) { pclose(pipe); };
+  std::unique_ptr<FILE, decltype(pipe_closer)> pipe(
+      popen(command.c_str(), "r"), pipe_closer);
+  if (!pipe)
+    throw std::runtime_error("Cant run '" + command + "'");
+  std::string text;
+  char buffer[4096];
+  while (const size_t read = fread(buffer, 1, sizeof(buffer), pipe.get()))
+    text.append(buffer, read);
+  if (pclose(pipe.release()) != 0)
+    throw std::runtime_error("'" + command + "' failed");
+
+  EngineOutput output;
+  for (const auto& line : split(text, '\n')) {
+    auto values = split(line, ' ');
+    const auto key = values.front();
+    values.erase(values.begin());
+    output[key] = std::move(values);
+  }
+  return output;
+}
+
+std::vector<double> to_numbers(const std::vector<std::string>& values) {
+  std::vector<double> numbers;
+  for (const auto& value : values)
+    numbers.push_back(std::stod(value));
+  return numbers;
+}
+
+double get_median(std::vector<double> values) {
+  std::sort(values.begin(), values.end());
+  return values[(values.size() - 1) / 2];
+}
+
+double get_sum(const std::vector<double>& values) {
+  double sum = 0;
+  for (const double value : values)
+    sum += value;
+  return sum;
+}
+
+// colors every engine knows, in EdgeColor order
+std::vector<EdgeColor> get_common_colors(
+    const std::vector<std::string>& engine_paths) {
+  std::vector<EdgeColor> colors = {EdgeColor::Gray, EdgeColor::Green,
+                                   EdgeColor::Blue, EdgeColor::Yellow,
+                                   EdgeColor::Red};
+  for (const auto& engine_path : engine_paths) {
+    const auto names = run_engine(engine_path, "colors")["colors"];
+    std::vector<EdgeColor> engine_colors;
+    for (const auto& name : names)
+      engine_colors.push_back(engine_harness::colors_from_string(name).front());
+    colors.erase(std::remove_if(colors.begin(), colors.end(),
+                                [&engine_colors](EdgeColor color) {
+                                  return std::find(engine_colors.begin(),
+                                                   engine_colors.end(),
+                                                   color) ==
+                                         engine_colors.end();
+                                }),
+                 colors.end());
+  }
+  return colors;
+}
+
+// shortest distances from the root to every vertex at the greatest depth,
+// sorted; engines differ in whether edges can be walked backwards
+std::vector<int> get_reference_distances(const InputGraph& graph,
+                                         bool is_directed) {
+  const int vertices_count = graph.parent_vertex_ids.size();
+  std::vector<std::vector<int>> adjacent_ids(vertices_count);
+  const auto add_edge = [&adjacent_ids, is_directed](int from_id, int to_id) {
+    adjacent_ids[from_id].push_back(to_id);
+    if (!is_directed && from_id != to_id)
+      adjacent_ids[to_id].push_back(from_id);
+  };
+  std::vector<int> depths(vertices_count, 0);
+  for (int vertex_id = 1; vertex_id < vertices_count; vertex_id++) {
+    const int parent_id = graph.parent_vertex_ids[vertex_id];
+    depths[vertex_id] = depths[parent_id] + 1;
+    add_edge(parent_id, vertex_id);
+  }
+  for (const auto& edge : graph.colored_edges)
+    add_edge(edge.from_vertex_id, edge.to_vertex_id);
+
+  std::vector<int> distances(vertices_count, -1);
+  std::queue<int> queue;
+  distances[0] = 0;
+  queue.push(0);
+  while (!queue.empty()) {
+    const int vertex_id = queue.front();
+    queue.pop();
+    for (const int adjacent_id : adjacent_ids[vertex_id])
+      if (distances[adjacent_id] == -1) {
+        distances[adjacent_id] = distances[vertex_id] + 1;
+        queue.push(adjacent_id);
+      }
+  }
+
+  const int max_depth = *std::max_element(depths.begin(), depths.end());
+  std::vector<int> res;
+  for (int vertex_id = 0; vertex_id < vertices_count; vertex_id++)
+    if (depths[vertex_id] == max_depth)
+      res.push_back(distances[vertex_id]);
+  std::sort(res.begin(), res.end());
+  return res;
+}
+
+std::vector<int> to_distances(const std::vector<std::string>& values) {
+  std::vector<int> distances;
+  for (const auto& value : values)
+    distances.push_back(std::stoi(value));
+  return distances;
+}
+
+std::string get_engine_name(const std::string& engine_path) {
+  const auto separator = engine_path.find_last_of('/');
+  return separator == std::string::npos ? engine_path
+                                        : engine_path.substr(separator + 1);
+}
+
+std::string bool_to_json(bool value) {
+  return value ? "true" : "false";
+}
+
+std::string number_to_json(double number) {
+  std::ostringstream stream;
+  stream << number;
+  return stream.str();
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  Options options;
+  try {
+    options = parse_options(argc, argv);
+  } catch (const std::exception& exception) {
+    std::cerr << exception.what() << std::endl;
+    return 1;
+  }
+
+  try {
+    const auto colors = get_common_colors(options.engine_paths);
+    const auto graph = engine_harness::generate_input_graph(
+        options.depth, options.new_vertices_count, options.seed, colors);
+    const std::string input_path =
+        "engine_harness_input_" + std::to_string(options.seed) + ".txt";
+    {
+      std::ofstream input(input_path, std::ofstream::trunc);
+      engine_harness::write_input_graph(input, graph);
+    }
+    const auto directed_distances = get_reference_distances(graph, true);
+    const auto undirected_distances = get_reference_distances(graph, false);
+
+    const std::string repetitions = std::to_string(options.repetitions);
+    std::vector<std::vector<int>> engine_distances;
+    std::string engines_json;
+    for (int i = 0; i < options.engine_paths.size(); i++) {
+      const auto& engine_path = options.engine_paths[i];
+      auto generation = run_engine(
+          engine_path, "generate " + std::to_string(options.depth) + " " +
+                           std::to_string(options.new_vertices_count) + " " +
+                           repetitions);
+      auto traversal =
+          run_engine(engine_path, "traverse " + input_path + " " + repetitions);
+      engine_distances.push_back(to_distances(traversal["distances"]));
+
+      const auto generation_seconds = to_numbers(generation["seconds"]);
+      const double total_seconds = get_sum(generation_seconds);
+      const double vertices_count = get_sum(to_numbers(generation["vertices"]));
+      const double edges_count = get_sum(to_numbers(generation["edges"]));
+      const auto& distances = engine_distances.back();
+
+      engines_json += "    {\n";
+      engines_json +=
+          "      \"engine\": \"" + get_engine_name(engine_path) + "\",\n";
+      engines_json += "      \"generation_p50_seconds\": " +
+                      number_to_json(get_median(generation_seconds)) + ",\n";
+      engines_json += "      \"generated_vertices_per_second\": " +
+                      number_to_json(total_seconds > 0
+                                         ? vertices_count / total_seconds
+                                         : 0) +
+                      ",\n";
+      engines_json += "      \"generated_edges_per_second\": " +
+                      number_to_json(total_seconds > 0
+                                         ? edges_count / total_seconds
+                                         : 0) +
+                      ",\n";
+      engines_json +=
+          "      \"load_p50_seconds\": " +
+          number_to_json(get_median(to_numbers(traversal["load_seconds"]))) +
+          ",\n";
+      engines_json += "      \"traverse_p50_seconds\": " +
+                      number_to_json(get_median(
+                          to_numbers(traversal["traverse_seconds"]))) +
+                      ",\n";
+      engines_json +=
+          "      \"paths\": " + std::to_string(distances.size()) + ",\n";
+      engines_json += "      \"matches_directed_bfs\": " +
+                      bool_to_json(distances == directed_distances) + ",\n";
+      engines_json += "      \"matches_undirected_bfs\": " +
+                      bool_to_json(distances == undirected_distances) + "\n";
+      engines_json += "    }";
+      engines_json += i + 1 < options.engine_paths.size() ? ",\n" : "\n";
+    }
+    std::remove(input_path.c_str());
+
+    bool is_agreed = true;
+    for (const auto& distances : engine_distances)
+      is_agreed = is_agreed && distances == engine_distances.front();
+
+    std::string colors_json;
+    for (const auto color : colors)
+      colors_json += std::string(colors_json.empty() ? "" : ", ") + "\"" +
+                     engine_harness::color_to_string(color) + "\"";
+    std::string res = "{\n";
+    res += "  \"depth\": " + std::to_string(options.depth) + ",\n";
+    res += "  \"new_vertices\": " +
+           std::to_string(options.new_vertices_count) + ",\n";
+    res += "  \"seed\": " + std::to_string(options.seed) + ",\n";
+    res += "  \"repetitions\": " + repetitions + ",\n";
+    res += "  \"colors\": [" + colors_json + "],\n";
+    res += "  \"input_vertices\": " +
+           std::to_string(graph.parent_vertex_ids.size()) + ",\n";
+    res += "  \"input_edges\": " +
+           std::to_string(graph.parent_vertex_ids.size() - 1 +
+                          graph.colored_edges.size()) +
+           ",\n";
+    res += "  \"traversals_agree\": " + bool_to_json(is_agreed) + ",\n";
+    res += "  \"engines\": [\n" + engines_json + "  ]\n}\n";
+
+    if (options.output_path.empty()) {
+      std::cout << res;
+    } else {
+      std::ofstream out(options.output_path, std::ofstream::trunc);
+      out << res;
+    }
+    if (!is_agreed) {
+      std::cerr << "Engines found different traversal distances" << std::endl;
+      return 2;
+    }
+  } catch (const std::exception& exception) {
+    std::cerr << exception.what() << std::endl;
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,151 @@
+#include <algorithm>
+#include <cstddef>
+#include <istream>
+#include <ostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "input_graph.hpp"
+
+namespace {
+
+using engine_harness::EdgeColor;
+using engine_harness::InputEdge;
+using engine_harness::InputGraph;
+
+constexpr double GREEN_PROBABILITY = 0.1;
+constexpr double BLUE_PROBABILITY = 0.25;
+constexpr double RED_PROBABILITY = 0.33;
+
+const std::vector<std::string> COLOR_NAMES = {"gray", "green", "blue",
+                                              "yellow", "red"};
+
+EdgeColor color_from_string(const std::string& name) {
+  for (int color = 0; color < COLOR_NAMES.size(); color++)
+    if (COLOR_NAMES[color] == name)
+      return static_cast<EdgeColor>(color);
+  throw std::invalid_argument("Unknown edge color '" + name + "'");
+}
+
+}  // namespace
+
+namespace engine_harness {
+
+InputGraph generate_input_graph(int depth,
+                                int new_vertices_count,
+                                int seed,
+                                const std::vector<EdgeColor>& colors) {
+  std::mt19937 random(seed);
+  std::uniform_real_distribution<> probability(0, 1);
+  const auto is_used = [&colors](EdgeColor color) {
+    for (const auto& used_color : colors)
+      if (used_color == color)
+        return true;
+    return false;
+  };
+
+  InputGraph graph;
+  graph.parent_vertex_ids.push_back(-1);
+  std::vector<std::vector<int>> vertex_ids_at_depth = {{0}};
+  for (int current_depth = 0; current_depth < depth; current_depth++) {
+    const double stop_probability =
+        static_cast<double>(current_depth) / static_cast<double>(depth);
+    std::vector<int> next_vertex_ids;
+    for (const int vertex_id : vertex_ids_at_depth[current_depth])
+      for (int i = 0; i < new_vertices_count; i++)
+        if (probability(random) > stop_probability) {
+          next_vertex_ids.push_back(graph.parent_vertex_ids.size());
+          graph.parent_vertex_ids.push_back(vertex_id);
+        }
+    if (next_vertex_ids.empty())
+      break;
+    vertex_ids_at_depth.push_back(std::move(next_vertex_ids));
+  }
+
+  const int graph_depth = vertex_ids_at_depth.size() - 1;
+  const auto pick = [&random](const std::vector<int>& vertex_ids) {
+    std::uniform_int_distribution<> index(0, vertex_ids.size() - 1);
+    return vertex_ids[index(random)];
+  };
+  for (int current_depth = 0; current_depth <= graph_depth; current_depth++) {
+    const auto& vertex_ids = vertex_ids_at_depth[current_depth];
+    for (int i = 0; i < vertex_ids.size(); i++) {
+      const int vertex_id = vertex_ids[i];
+      if (is_used(EdgeColor::Green) && probability(random) < GREEN_PROBABILITY)
+        graph.colored_edges.push_back({vertex_id, vertex_id, EdgeColor::Green});
+      if (is_used(EdgeColor::Blue) && i + 1 < vertex_ids.size() &&
+          probability(random) < BLUE_PROBABILITY)
+        graph.colored_edges.push_back(
+            {vertex_id, vertex_ids[i + 1], EdgeColor::Blue});
+      if (is_used(EdgeColor::Yellow) && current_depth < graph_depth &&
+          probability(random) <
+              static_cast<double>(current_depth) / graph_depth) {
+        // children are already joined to the vertex by gray edges
+        std::vector<int> candidate_ids;
+        for (const int next_vertex_id : vertex_ids_at_depth[current_depth + 1])
+          if (graph.parent_vertex_ids[next_vertex_id] != vertex_id)
+            candidate_ids.push_back(next_vertex_id);
+        if (!candidate_ids.empty())
+          graph.colored_edges.push_back(
+              {vertex_id, pick(candidate_ids), EdgeColor::Yellow});
+      }
+      if (is_used(EdgeColor::Red) && current_depth + 2 <= graph_depth &&
+          probability(random) < RED_PROBABILITY)
+        graph.colored_edges.push_back(
+            {vertex_id, pick(vertex_ids_at_depth[current_depth + 2]),
+             EdgeColor::Red});
+    }
+  }
+  return graph;
+}
+
+std::string color_to_string(EdgeColor color) {
+  return COLOR_NAMES[static_cast<int>(color)];
+}
+
+std::vector<EdgeColor> colors_from_string(const std::string& names) {
+  std::vector<EdgeColor> colors;
+  size_t begin = 0;
+  while (begin <= names.size()) {
+    const size_t end = std::min(names.find(',', begin), names.size());
+    colors.push_back(color_from_string(names.substr(begin, end - begin)));
+    begin = end + 1;
+  }
+  return colors;
+}
+
+void write_input_graph(std::ostream& out, const InputGraph& graph) {
+  out << "vertices " << graph.parent_vertex_ids.size() << "\n";
+  for (const int parent_vertex_id : graph.parent_vertex_ids)
+    out << parent_vertex_id << "\n";
+  out << "edges " << graph.colored_edges.size() << "\n";
+  for (const auto& edge : graph.colored_edges)
+    out << edge.from_vertex_id << " " << edge.to_vertex_id << " "
+        << color_to_string(edge.color) << "\n";
+}
+
+InputGraph read_input_graph(std::istream& in) {
+  InputGraph graph;
+  std::string header;
+  int count = 0;
+  if (!(in >> header >> count) || header != "vertices")
+    throw std::invalid_argument("Expected vertices count");
+  graph.parent_vertex_ids.resize(count);
+  for (auto& parent_vertex_id : graph.parent_vertex_ids)
+    in >> parent_vertex_id;
+  if (!(in >> header >> count) || header != "edges")
+    throw std::invalid_argument("Expected edges count");
+  graph.colored_edges.resize(count);
+  for (auto& edge : graph.colored_edges) {
+    std::string color;
+    in >> edge.from_vertex_id >> edge.to_vertex_id >> color;
+    edge.color = color_from_string(color);
+  }
+  if (!in)
+    throw std::invalid_argument("Truncated input graph");
+  return graph;
+}
+
+}  // namespace engine_harness
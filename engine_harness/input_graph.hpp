@@ -0,0 +1,42 @@
+#pragma once
+
+#include <istream>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace engine_harness {
+
+enum class EdgeColor { Gray, Green, Blue, Yellow, Red };
+
+struct InputEdge {
+  int from_vertex_id = 0;
+  int to_vertex_id = 0;
+  EdgeColor color = EdgeColor::Gray;
+};
+
+// graph every engine loads identically: vertex 0 is the root, every other
+// vertex is added right after its parent and joined to it by a gray edge,
+// then the colored edges follow in creation order
+struct InputGraph {
+  // parent of every vertex, -1 for the root
+  std::vector<int> parent_vertex_ids;
+  std::vector<InputEdge> colored_edges;
+};
+
+// builds a graph by the rules all engines implement, with a seeded generator
+// instead of the engines' own unseeded randomness; edges of colors missing
+// from colors are left out, so engines without them load the same graph
+InputGraph generate_input_graph(int depth,
+                                int new_vertices_count,
+                                int seed,
+                                const std::vector<EdgeColor>& colors);
+
+std::string color_to_string(EdgeColor color);
+// comma separated color names, as color_to_string writes them
+std::vector<EdgeColor> colors_from_string(const std::string& names);
+
+void write_input_graph(std::ostream& out, const InputGraph& graph);
+InputGraph read_input_graph(std::istream& in);
+
+}  // namespace engine_harness
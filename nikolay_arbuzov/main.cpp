@@ -5,7 +5,6 @@
 #include <set>
 #include <sstream>
 #include <string>
-#include <unordered_map>
 #include <vector>
 
 using VertexId = int;
@@ -31,17 +30,15 @@ class Graph {
  public:
   Vertex& add_vertex() {
     VertexId new_vertex_id = get_new_vertex_id();
-    adjacency_list_[new_vertex_id] = std::set<EdgeId>();
+    adjacency_list_.emplace_back();
     return vertices_.emplace_back(new_vertex_id);
   };
 
+  // ids are dense counters, so vertices and edges are stored at the index
+  // of their id
   bool has_vertex(const VertexId& vertex_id) const {
-    for (auto vertex : vertices_) {
-      if (vertex.id == vertex_id) {
-        return true;
-      }
-    }
-    return false;
+    return vertex_id >= 0 &&
+           vertex_id < static_cast<VertexId>(vertices_.size());
   };
 
   Edge& add_edge(const VertexId& from_vertex_id, const VertexId& to_vertex_id) {
@@ -54,29 +51,23 @@ class Graph {
   };
 
   bool has_edge(const EdgeId& edge_id) const {
-    for (auto edge : edges_) {
-      if (edge.id == edge_id) {
-        return true;
-      }
-    }
-    return false;
+    return edge_id >= 0 && edge_id < static_cast<EdgeId>(edges_.size());
   };
 
   const Vertex& get_vertex(const VertexId& vertex_id) const {
-    for (const auto& vertex : vertices_) {
-      if (vertex.id == vertex_id) {
-        return vertex;
-      }
+    if (!has_vertex(vertex_id)) {
+      throw std::runtime_error("No such vertex");
     }
-    throw std::runtime_error("No such vertex");
+    assert(vertices_[vertex_id].id == vertex_id &&
+           "Vertex is stored out of order");
+    return vertices_[vertex_id];
   }
   const Edge& get_edge(const EdgeId& edge_id) const {
-    for (const auto& edge : edges_) {
-      if (edge.id == edge_id) {
-        return edge;
-      }
+    if (!has_edge(edge_id)) {
+      throw std::runtime_error("No such edge");
     }
-    throw std::runtime_error("No such edge");
+    assert(edges_[edge_id].id == edge_id && "Edge is stored out of order");
+    return edges_[edge_id];
   }
 
   const std::vector<Vertex>& vertices() const { return vertices_; }
@@ -89,7 +80,7 @@ class Graph {
  private:
   std::vector<Edge> edges_;
   std::vector<Vertex> vertices_;
-  std::unordered_map<VertexId, std::set<EdgeId>> adjacency_list_;
+  std::vector<std::set<EdgeId>> adjacency_list_;
 
   EdgeId edges_id_counter_ = 0;
   VertexId vertex_id_counter_ = 0;
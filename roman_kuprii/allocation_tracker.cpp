@@ -0,0 +1,243 @@
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include <optional>
+
+#if defined(__GLIBC__)
+#include <malloc.h>
+#define ALLOCATION_TRACKING_HAS_USABLE_SIZE
+#endif
+
+#include "allocation_tracker.hpp"
+
+namespace uni_cpp_practice {
+
+namespace {
+
+std::atomic<bool> is_tracking_enabled = false;
+
+// constant initialized, so the hooks can use them before main and while
+// threads are being torn down
+thread_local allocation_tracking::Context current_context;
+
+std::atomic<uint64_t> run_allocations = 0;
+std::atomic<uint64_t> run_deallocations = 0;
+std::atomic<uint64_t> run_allocated_bytes = 0;
+std::atomic<uint64_t> run_freed_bytes = 0;
+std::atomic<int64_t> run_live_bytes = 0;
+std::atomic<uint64_t> run_peak_bytes = 0;
+
+void update_peak(std::atomic<uint64_t>& peak_bytes, int64_t live_bytes) {
+  if (live_bytes <= 0)
+    return;
+  uint64_t current_peak = peak_bytes.load(std::memory_order_relaxed);
+  while (current_peak < static_cast<uint64_t>(live_bytes) &&
+         !peak_bytes.compare_exchange_weak(current_peak, live_bytes,
+                                           std::memory_order_relaxed)) {
+  }
+}
+
+}  // namespace
+
+namespace allocation_tracking {
+
+void set_enabled(bool is_enabled) {
+  is_tracking_enabled = is_enabled && is_available();
+}
+
+bool is_enabled() {
+  return is_tracking_enabled.load(std::memory_order_relaxed);
+}
+
+bool is_available() {
+#if defined(ALLOCATION_TRACKING_HAS_USABLE_SIZE)
+  return true;
+#else
+  return false;
+#endif
+}
+
+AllocationStats get_run_stats() {
+  AllocationStats stats;
+  stats.allocations = run_allocations;
+  stats.deallocations = run_deallocations;
+  stats.allocated_bytes = run_allocated_bytes;
+  stats.freed_bytes = run_freed_bytes;
+  stats.peak_bytes = run_peak_bytes;
+  return stats;
+}
+
+void JobAllocations::Counters::add_allocation(size_t bytes) {
+  allocations.fetch_add(1, std::memory_order_relaxed);
+  allocated_bytes.fetch_add(bytes, std::memory_order_relaxed);
+  update_peak(peak_bytes,
+              live_bytes.fetch_add(bytes, std::memory_order_relaxed) + bytes);
+}
+
+void JobAllocations::Counters::add_deallocation(size_t bytes) {
+  deallocations.fetch_add(1, std::memory_order_relaxed);
+  freed_bytes.fetch_add(bytes, std::memory_order_relaxed);
+  live_bytes.fetch_sub(bytes, std::memory_order_relaxed);
+}
+
+AllocationStats JobAllocations::Counters::get() const {
+  AllocationStats stats;
+  stats.allocations = allocations;
+  stats.deallocations = deallocations;
+  stats.allocated_bytes = allocated_bytes;
+  stats.freed_bytes = freed_bytes;
+  stats.peak_bytes = peak_bytes;
+  return stats;
+}
+
+void JobAllocations::add_allocation(std::optional<phase_timers::Phase> phase,
+                                    size_t bytes) {
+  total_.add_allocation(bytes);
+  if (phase.has_value())
+    phases_[static_cast<int>(phase.value())].add_allocation(bytes);
+}
+
+void JobAllocations::add_deallocation(
+    std::optional<phase_timers::Phase> phase,
+    size_t bytes) {
+  total_.add_deallocation(bytes);
+  if (phase.has_value())
+    phases_[static_cast<int>(phase.value())].add_deallocation(bytes);
+}
+
+AllocationStats JobAllocations::get_total() const {
+  return total_.get();
+}
+
+JobAllocations::PhaseStats JobAllocations::get_phases() const {
+  PhaseStats res;
+  for (int phase = 0; phase < phase_timers::PHASES_COUNT; phase++)
+    res[phase] = phases_[phase].get();
+  return res;
+}
+
+Context get_context() {
+  return current_context;
+}
+
+void set_context(const Context& context) {
+  current_context = context;
+}
+
+}  // namespace allocation_tracking
+
+#if defined(ALLOCATION_TRACKING_HAS_USABLE_SIZE)
+
+namespace {
+
+using allocation_tracking::Context;
+
+// blocks are measured by their usable size on both ends, so a block is
+// released with exactly the bytes it was counted with
+void record_allocation(void* pointer) {
+  if (!is_tracking_enabled.load(std::memory_order_relaxed))
+    return;
+  const size_t bytes = malloc_usable_size(pointer);
+  run_allocations.fetch_add(1, std::memory_order_relaxed);
+  run_allocated_bytes.fetch_add(bytes, std::memory_order_relaxed);
+  update_peak(run_peak_bytes,
+              run_live_bytes.fetch_add(bytes, std::memory_order_relaxed) +
+                  bytes);
+  const Context& context = current_context;
+  if (context.job != nullptr)
+    context.job->add_allocation(context.phase, bytes);
+}
+
+void record_deallocation(void* pointer) {
+  if (pointer == nullptr ||
+      !is_tracking_enabled.load(std::memory_order_relaxed))
+    return;
+  const size_t bytes = malloc_usable_size(pointer);
+  run_deallocations.fetch_add(1, std::memory_order_relaxed);
+  run_freed_bytes.fetch_add(bytes, std::memory_order_relaxed);
+  run_live_bytes.fetch_sub(bytes, std::memory_order_relaxed);
+  const Context& context = current_context;
+  if (context.job != nullptr)
+    context.job->add_deallocation(context.phase, bytes);
+}
+
+void* allocate(size_t size) {
+  if (size == 0)
+    size = 1;
+  while (true) {
+    if (void* pointer = std::malloc(size)) {
+      record_allocation(pointer);
+      return pointer;
+    }
+    const auto new_handler = std::get_new_handler();
+    if (new_handler == nullptr)
+      throw std::bad_alloc();
+    new_handler();
+  }
+}
+
+void* allocate_nothrow(size_t size) noexcept {
+  try {
+    return allocate(size);
+  } catch (...) {
+    return nullptr;
+  }
+}
+
+void deallocate(void* pointer) noexcept {
+  record_deallocation(pointer);
+  std::free(pointer);
+}
+
+}  // namespace
+
+#endif
+
+}  // namespace uni_cpp_practice
+
+#if defined(ALLOCATION_TRACKING_HAS_USABLE_SIZE)
+
+// over-aligned allocations keep the default operators and are not counted
+void* operator new(size_t size) {
+  return uni_cpp_practice::allocate(size);
+}
+
+void* operator new[](size_t size) {
+  return uni_cpp_practice::allocate(size);
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+  return uni_cpp_practice::allocate_nothrow(size);
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept {
+  return uni_cpp_practice::allocate_nothrow(size);
+}
+
+void operator delete(void* pointer) noexcept {
+  uni_cpp_practice::deallocate(pointer);
+}
+
+void operator delete[](void* pointer) noexcept {
+  uni_cpp_practice::deallocate(pointer);
+}
+
+void operator delete(void* pointer, size_t) noexcept {
+  uni_cpp_practice::deallocate(pointer);
+}
+
+void operator delete[](void* pointer, size_t) noexcept {
+  uni_cpp_practice::deallocate(pointer);
+}
+
+void operator delete(void* pointer, const std::nothrow_t&) noexcept {
+  uni_cpp_practice::deallocate(pointer);
+}
+
+void operator delete[](void* pointer, const std::nothrow_t&) noexcept {
+  uni_cpp_practice::deallocate(pointer);
+}
+
+#endif
@@ -0,0 +1,113 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+#include "phase_timers.hpp"
+
+namespace uni_cpp_practice {
+
+namespace allocation_tracking {
+
+struct AllocationStats {
+  uint64_t allocations = 0;
+  uint64_t deallocations = 0;
+  uint64_t allocated_bytes = 0;
+  uint64_t freed_bytes = 0;
+  // high-water mark of allocated minus freed bytes
+  uint64_t peak_bytes = 0;
+};
+
+// global operator new and delete are counted only while tracking is enabled,
+// it is off by default. Not available without glibc, the hooks need the
+// usable size of a block to account for its release
+void set_enabled(bool is_enabled);
+bool is_enabled();
+bool is_available();
+
+// everything allocated and freed by the process while enabled, peak_bytes is
+// the high-water mark of the tracked heap
+AllocationStats get_run_stats();
+
+// allocations of one controller job, filled from any thread that runs on its
+// behalf, broken down by the phase they happened in
+class JobAllocations {
+ public:
+  using PhaseStats = std::array<AllocationStats, phase_timers::PHASES_COUNT>;
+
+  JobAllocations() = default;
+
+  JobAllocations(const JobAllocations&) = delete;
+  JobAllocations& operator=(const JobAllocations&) = delete;
+
+  void add_allocation(std::optional<phase_timers::Phase> phase, size_t bytes);
+  void add_deallocation(std::optional<phase_timers::Phase> phase,
+                        size_t bytes);
+
+  AllocationStats get_total() const;
+  PhaseStats get_phases() const;
+
+ private:
+  struct Counters {
+    std::atomic<uint64_t> allocations = 0;
+    std::atomic<uint64_t> deallocations = 0;
+    std::atomic<uint64_t> allocated_bytes = 0;
+    std::atomic<uint64_t> freed_bytes = 0;
+    std::atomic<int64_t> live_bytes = 0;
+    std::atomic<uint64_t> peak_bytes = 0;
+
+    void add_allocation(size_t bytes);
+    void add_deallocation(size_t bytes);
+    AllocationStats get() const;
+  };
+
+  Counters total_;
+  std::array<Counters, phase_timers::PHASES_COUNT> phases_;
+};
+
+// what the allocations of the calling thread are attributed to
+struct Context {
+  JobAllocations* job = nullptr;
+  std::optional<phase_timers::Phase> phase = std::nullopt;
+};
+
+Context get_context();
+void set_context(const Context& context);
+
+// sets the context for the lifetime of the scope, threads started on behalf of
+// a job take the context of the thread that started them this way
+class ScopedContext {
+ public:
+  explicit ScopedContext(const Context& context)
+      : previous_context_(get_context()) {
+    set_context(context);
+  }
+
+  ScopedContext(const ScopedContext&) = delete;
+  ScopedContext& operator=(const ScopedContext&) = delete;
+
+  ~ScopedContext() { set_context(previous_context_); }
+
+ private:
+  const Context previous_context_;
+};
+
+// attributes the allocations of the scope to the job, outside of any phase
+class ScopedJob : public ScopedContext {
+ public:
+  explicit ScopedJob(JobAllocations* job) : ScopedContext({job}) {}
+};
+
+// attributes the allocations of the scope to the phase of the current job
+class ScopedPhase : public ScopedContext {
+ public:
+  explicit ScopedPhase(phase_timers::Phase phase)
+      : ScopedContext({get_context().job, phase}) {}
+};
+
+}  // namespace allocation_tracking
+
+}  // namespace uni_cpp_practice
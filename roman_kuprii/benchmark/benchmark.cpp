@@ -0,0 +1,437 @@
+// runs generation, serialization and traversal for every cell of a parameter
+// matrix and prints the timings as json, without any interactive input.
+//
+//   benchmark --depth 4,6 --new_vertices 3 --threads 1,4 --graphs 8
+//             --warmups 1 --repetitions 5 [--counters 1]
+//             [--config matrix.txt] [--output f]
+//
+// a config file holds the same keys, one "key = values" line each, and
+// command line values override it. warmups, repetitions and counters take a
+// single value, values out of range stop the benchmark. With counters every
+// phase also reports hardware counters, when the kernel lets perf_event_open
+// count them
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <optional>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "../graph.hpp"
+#include "../graph_generation_controller.hpp"
+#include "../graph_generator.hpp"
+#include "../graph_pool.hpp"
+#include "../graph_printing.hpp"
+#include "../graph_snapshot.hpp"
+#include "../graph_traversal_controller.hpp"
+#include "../graph_traverser.hpp"
+#include "perf_counters.hpp"
+
+namespace {
+
+using uni_cpp_practice::GraphGenerator;
+using uni_cpp_practice::GraphPool;
+using uni_cpp_practice::GraphSnapshot;
+using uni_cpp_practice::GraphTraverser;
+using uni_cpp_practice::graph_generation_controller::GraphGenerationController;
+using uni_cpp_practice::graph_traversal_controller::GraphTraversalController;
+using uni_cpp_practice::perf_counters::CounterGroup;
+
+using Matrix = std::map<std::string, std::vector<int>>;
+
+const Matrix DEFAULT_MATRIX = {
+    {"graphs", {4}},      {"depth", {4}},   {"new_vertices", {3}},
+    {"threads", {1}},     {"warmups", {1}}, {"repetitions", {5}},
+    {"counters", {0}},
+};
+
+// accepted values of every parameter, the scalar ones take a single value
+struct ParameterRule {
+  int min_value = 0;
+  int max_value = std::numeric_limits<int>::max();
+  bool is_scalar = false;
+};
+
+const std::map<std::string, ParameterRule> PARAMETER_RULES = {
+    {"graphs", {1}},
+    {"depth", {0}},
+    {"new_vertices", {1}},
+    {"threads", {1}},
+    {"warmups", {0, std::numeric_limits<int>::max(), true}},
+    {"repetitions", {1, std::numeric_limits<int>::max(), true}},
+    {"counters", {0, 1, true}},
+};
+
+const std::vector<double> PERCENTILES = {50, 90, 99};
+
+std::vector<int> parse_values(const std::string& text) {
+  std::vector<int> values;
+  std::stringstream stream(text);
+  std::string value;
+  while (std::getline(stream, value, ',')) {
+    // stoi stops at the first non digit, so "10x" would pass as 10
+    size_t pos = 0;
+    values.push_back(std::stoi(value, &pos));
+    if (pos != value.size())
+      throw std::invalid_argument("Bad value '" + value + "' in '" + text +
+                                  "'");
+  }
+  if (values.empty())
+    throw std::invalid_argument("No values given in '" + text + "'");
+  return values;
+}
+
+void set_values(Matrix& matrix,
+                const std::string& key,
+                const std::string& values) {
+  if (DEFAULT_MATRIX.find(key) == DEFAULT_MATRIX.end())
+    throw std::invalid_argument("Unknown parameter '" + key + "'");
+  matrix[key] = parse_values(values);
+}
+
+std::string trim(const std::string& text) {
+  const auto begin = text.find_first_not_of(" \t\r");
+  if (begin == std::string::npos)
+    return "";
+  const auto end = text.find_last_not_of(" \t\r");
+  return text.substr(begin, end - begin + 1);
+}
+
+void read_config(Matrix& matrix, const std::string& file_path) {
+  std::ifstream file(file_path);
+  if (!file)
+    throw std::invalid_argument("Cant open config '" + file_path + "'");
+  std::string line;
+  while (std::getline(file, line)) {
+    line = trim(line.substr(0, line.find('#')));
+    if (line.empty())
+      continue;
+    const auto separator = line.find('=');
+    if (separator == std::string::npos)
+      throw std::invalid_argument("Bad config line '" + line + "'");
+    set_values(matrix, trim(line.substr(0, separator)),
+               trim(line.substr(separator + 1)));
+  }
+}
+
+void validate_matrix(const Matrix& matrix) {
+  for (const auto& [key, values] : matrix) {
+    const auto& rule = PARAMETER_RULES.at(key);
+    if (rule.is_scalar && values.size() > 1)
+      throw std::invalid_argument("Parameter '" + key +
+                                  "' takes a single value");
+    for (const int value : values)
+      if (value < rule.min_value || value > rule.max_value)
+        throw std::invalid_argument(
+            "Parameter '" + key + "' is out of range: " +
+            std::to_string(value) + ", expected at least " +
+            std::to_string(rule.min_value) +
+            (rule.max_value < std::numeric_limits<int>::max()
+                 ? " and at most " + std::to_string(rule.max_value)
+                 : ""));
+  }
+}
+
+struct Options {
+  Matrix matrix = DEFAULT_MATRIX;
+  std::string output_path;
+};
+
+Options parse_options(int argc, char** argv) {
+  Options options;
+  Matrix command_line;
+  for (int i = 1; i < argc; i += 2) {
+    const std::string flag = argv[i];
+    if (flag.rfind("--", 0) != 0 || i + 1 == argc)
+      throw std::invalid_argument("Expected '--key value', got '" + flag +
+                                  "'");
+    const std::string key = flag.substr(2);
+    const std::string value = argv[i + 1];
+    if (key == "config")
+      read_config(options.matrix, value);
+    else if (key == "output")
+      options.output_path = value;
+    else
+      set_values(command_line, key, value);
+  }
+  for (const auto& [key, values] : command_line)
+    options.matrix[key] = values;
+  validate_matrix(options.matrix);
+  return options;
+}
+
+struct Cell {
+  int graphs_count = 0;
+  int depth = 0;
+  int new_vertices_num = 0;
+  int threads_count = 0;
+};
+
+std::vector<Cell> get_cells(const Matrix& matrix) {
+  std::vector<Cell> cells;
+  for (const int graphs_count : matrix.at("graphs"))
+    for (const int depth : matrix.at("depth"))
+      for (const int new_vertices_num : matrix.at("new_vertices"))
+        for (const int threads_count : matrix.at("threads"))
+          cells.push_back({graphs_count, depth, new_vertices_num,
+                           threads_count});
+  return cells;
+}
+
+// wall seconds and processed items of every repetition of one phase
+struct PhaseSamples {
+  std::vector<double> seconds;
+  // item name to the count processed in every repetition
+  std::map<std::string, std::vector<double>> items;
+  // hardware counter name to its value in every repetition
+  std::map<std::string, std::vector<double>> counters;
+};
+
+struct CellSamples {
+  PhaseSamples generation;
+  PhaseSamples serialization;
+  PhaseSamples freezing;
+  PhaseSamples traversal;
+};
+
+struct Measurement {
+  double seconds = 0;
+  std::map<std::string, double> counters;
+};
+
+// counts the job with counter_group unless it is null
+Measurement measure(const std::function<void()>& job,
+                    CounterGroup* counter_group) {
+  Measurement measurement;
+  if (counter_group != nullptr)
+    counter_group->start();
+  const auto start = std::chrono::steady_clock::now();
+  job();
+  const std::chrono::duration<double> duration =
+      std::chrono::steady_clock::now() - start;
+  if (counter_group != nullptr)
+    measurement.counters = counter_group->stop();
+  measurement.seconds = duration.count();
+  return measurement;
+}
+
+void add_measurement(PhaseSamples& samples, const Measurement& measurement) {
+  samples.seconds.push_back(measurement.seconds);
+  for (const auto& [name, value] : measurement.counters)
+    samples.counters[name].push_back(value);
+}
+
+void run_repetition(const Cell& cell,
+                    CounterGroup* counter_group,
+                    CellSamples* samples) {
+  const auto params =
+      GraphGenerator::Params(cell.depth, cell.new_vertices_num);
+  std::vector<GraphPool::Handle> graphs(cell.graphs_count);
+  const auto generation = measure(
+      [&cell, &params, &graphs]() {
+        auto controller = GraphGenerationController(cell.threads_count,
+                                                    cell.graphs_count, params);
+        controller.generate([](int) {},
+                            [&graphs](GraphPool::Handle graph, int index) {
+                              graphs[index] = std::move(graph);
+                            });
+      },
+      counter_group);
+
+  double vertices_count = 0;
+  double edges_count = 0;
+  for (const auto& graph : graphs) {
+    vertices_count += graph->get_vertices().size();
+    edges_count += graph->get_edges().size();
+  }
+
+  double json_bytes = 0;
+  const auto serialization = measure(
+      [&graphs, &json_bytes]() {
+        for (const auto& graph : graphs)
+          json_bytes +=
+              uni_cpp_practice::graph_printing::graph_to_json(*graph).size();
+      },
+      counter_group);
+
+  std::vector<GraphSnapshot> snapshots;
+  snapshots.reserve(graphs.size());
+  const auto freezing = measure(
+      [&graphs, &snapshots]() {
+        for (const auto& graph : graphs)
+          snapshots.push_back(GraphSnapshot::freeze(*graph));
+      },
+      counter_group);
+  graphs.clear();
+
+  double paths_count = 0;
+  const auto traversal = measure(
+      [&cell, &snapshots, &paths_count]() {
+        auto controller =
+            GraphTraversalController(cell.threads_count, std::move(snapshots));
+        controller.traverse_graphs(
+            [](int) {},
+            [&paths_count](int, const std::vector<GraphTraverser::Path>& paths,
+                           size_t) { paths_count += paths.size(); });
+      },
+      counter_group);
+
+  if (samples == nullptr)
+    return;
+  add_measurement(samples->generation, generation);
+  samples->generation.items["vertices"].push_back(vertices_count);
+  samples->generation.items["edges"].push_back(edges_count);
+  add_measurement(samples->serialization, serialization);
+  samples->serialization.items["bytes"].push_back(json_bytes);
+  add_measurement(samples->freezing, freezing);
+  samples->freezing.items["vertices"].push_back(vertices_count);
+  add_measurement(samples->traversal, traversal);
+  samples->traversal.items["paths"].push_back(paths_count);
+}
+
+// nearest-rank percentile of sorted values
+double get_percentile(const std::vector<double>& sorted_values,
+                      double percentile) {
+  const int rank = std::ceil(percentile / 100 * sorted_values.size());
+  return sorted_values[std::max(rank, 1) - 1];
+}
+
+std::string number_to_json(double number) {
+  std::ostringstream stream;
+  stream << number;
+  return stream.str();
+}
+
+std::string phase_to_json(const PhaseSamples& samples) {
+  auto sorted_seconds = samples.seconds;
+  std::sort(sorted_seconds.begin(), sorted_seconds.end());
+  double total_seconds = 0;
+  for (const double seconds : sorted_seconds)
+    total_seconds += seconds;
+
+  std::string res = "{\"wall_seconds\": {";
+  res += "\"min\": " + number_to_json(sorted_seconds.front()) + ", ";
+  res += "\"mean\": " +
+         number_to_json(total_seconds / sorted_seconds.size()) + ", ";
+  for (const double percentile : PERCENTILES)
+    res += "\"p" + number_to_json(percentile) + "\": " +
+           number_to_json(get_percentile(sorted_seconds, percentile)) + ", ";
+  res += "\"max\": " + number_to_json(sorted_seconds.back()) + ", ";
+  // in repetition order, for the significance tests of benchmark/compare
+  res += "\"samples\": [";
+  for (int i = 0; i < static_cast<int>(samples.seconds.size()); i++)
+    res += (i > 0 ? ", " : "") + number_to_json(samples.seconds[i]);
+  res += "]}";
+  // throughput over all repetitions together
+  for (const auto& [item, counts] : samples.items) {
+    double total_count = 0;
+    for (const double count : counts)
+      total_count += count;
+    res += ", \"" + item + "_per_second\": " +
+           number_to_json(total_seconds > 0 ? total_count / total_seconds : 0);
+  }
+  // mean per repetition, repetitions the kernel didnt count are left out
+  if (!samples.counters.empty()) {
+    std::map<std::string, double> means;
+    for (const auto& [name, values] : samples.counters) {
+      double total_value = 0;
+      for (const double value : values)
+        total_value += value;
+      means[name] = total_value / values.size();
+    }
+    res += ", \"counters\": {";
+    for (const auto& [name, mean] : means)
+      res += "\"" + name + "\": " + number_to_json(mean) + ", ";
+    const auto cycles = means.find("cycles");
+    const auto instructions = means.find("instructions");
+    if (cycles != means.end() && instructions != means.end() &&
+        cycles->second > 0)
+      res += "\"ipc\": " +
+             number_to_json(instructions->second / cycles->second) + ", ";
+    res.pop_back();
+    res.pop_back();
+    res += "}";
+  }
+  res += "}";
+  return res;
+}
+
+std::string cell_to_json(const Cell& cell,
+                         int repetitions,
+                         const CellSamples& samples) {
+  std::string res = "    {\n";
+  res += "      \"graphs\": " + std::to_string(cell.graphs_count) + ",\n";
+  res += "      \"depth\": " + std::to_string(cell.depth) + ",\n";
+  res += "      \"new_vertices\": " + std::to_string(cell.new_vertices_num) +
+         ",\n";
+  res += "      \"threads\": " + std::to_string(cell.threads_count) + ",\n";
+  res += "      \"repetitions\": " + std::to_string(repetitions) + ",\n";
+  res += "      \"generation\": " + phase_to_json(samples.generation) + ",\n";
+  res += "      \"serialization\": " + phase_to_json(samples.serialization) +
+         ",\n";
+  res += "      \"freezing\": " + phase_to_json(samples.freezing) + ",\n";
+  res += "      \"traversal\": " + phase_to_json(samples.traversal) + "\n";
+  res += "    }";
+  return res;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  Options options;
+  try {
+    options = parse_options(argc, argv);
+  } catch (const std::exception& exception) {
+    std::cerr << exception.what() << std::endl;
+    return 1;
+  }
+  const int warmups = options.matrix.at("warmups").front();
+  const int repetitions = options.matrix.at("repetitions").front();
+  const bool with_counters = options.matrix.at("counters").front() != 0;
+
+  std::optional<CounterGroup> counter_group;
+  if (with_counters)
+    counter_group.emplace();
+  std::string res = "{\n";
+  if (counter_group.has_value()) {
+    // runs still go on without counters, only timings are reported then
+    res += "  \"counters_available\": " +
+           std::string(counter_group->is_available() ? "true" : "false") +
+           ",\n";
+    if (!counter_group->get_error().empty())
+      res += "  \"counters_error\": \"" + counter_group->get_error() +
+             "\",\n";
+  }
+  res += "  \"cells\": [\n";
+  CounterGroup* const counting_group =
+      counter_group.has_value() && counter_group->is_available()
+          ? &counter_group.value()
+          : nullptr;
+  const auto cells = get_cells(options.matrix);
+  for (int i = 0; i < static_cast<int>(cells.size()); i++) {
+    for (int warmup = 0; warmup < warmups; warmup++)
+      run_repetition(cells[i], nullptr, nullptr);
+    CellSamples samples;
+    for (int repetition = 0; repetition < repetitions; repetition++)
+      run_repetition(cells[i], counting_group, &samples);
+    res += cell_to_json(cells[i], repetitions, samples);
+    res += i + 1 < static_cast<int>(cells.size()) ? ",\n" : "\n";
+  }
+  res += "  ]\n}\n";
+
+  if (options.output_path.empty()) {
+    std::cout << res;
+  } else {
+    std::ofstream out(options.output_path, std::ofstream::trunc);
+    out << res;
+  }
+  return 0;
+}
@@ -0,0 +1,386 @@
+// compares two result files of benchmark or microbenchmark and exits with 1
+// when the candidate is significantly slower in any metric.
+//
+//   compare baseline.json candidate.json [--alpha 0.05] [--threshold 0.05]
+//
+// every timing with repetition samples is a metric. A metric regresses when
+// a one-sided Mann-Whitney U test says the candidate samples are larger at
+// the alpha level and the medians differ by more than threshold, so noise
+// and negligible slowdowns pass. Five or more repetitions per side are
+// needed for the test to ever reach alpha 0.05
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+
+// fields that tell the cells of a benchmark matrix apart, results of
+// microbenchmark carry a name instead
+const std::vector<std::string> CELL_KEYS = {"graphs", "depth", "new_vertices",
+                                            "threads"};
+
+// exact p-values are counted for up to this many sample pairs
+constexpr int MAX_EXACT_PAIRS_COUNT = 2500;
+
+struct JsonValue {
+  enum class Type { Null, Bool, Number, String, Array, Object };
+
+  Type type = Type::Null;
+  bool boolean = false;
+  double number = 0;
+  std::string string;
+  std::vector<JsonValue> array;
+  // in file order
+  std::vector<std::pair<std::string, JsonValue>> object;
+
+  const JsonValue* find(const std::string& key) const {
+    for (const auto& [name, value] : object)
+      if (name == key)
+        return &value;
+    return nullptr;
+  }
+};
+
+// just enough json for the files the benchmarks write
+class JsonParser {
+ public:
+  explicit JsonParser(const std::string& text) : text_(text) {}
+
+  JsonValue parse() {
+    auto value = parse_value();
+    skip_spaces();
+    if (position_ != text_.size())
+      throw_error("Unexpected trailing characters");
+    return value;
+  }
+
+ private:
+  const std::string& text_;
+  size_t position_ = 0;
+
+  [[noreturn]] void throw_error(const std::string& message) const {
+    throw std::invalid_argument(message + " at offset " +
+                                std::to_string(position_));
+  }
+
+  void skip_spaces() {
+    while (position_ < text_.size() &&
+           std::isspace(static_cast<unsigned char>(text_[position_])))
+      position_++;
+  }
+
+  bool consume(char symbol) {
+    skip_spaces();
+    if (position_ < text_.size() && text_[position_] == symbol) {
+      position_++;
+      return true;
+    }
+    return false;
+  }
+
+  void expect(char symbol) {
+    if (!consume(symbol))
+      throw_error(std::string("Expected '") + symbol + "'");
+  }
+
+  bool consume_word(const std::string& word) {
+    if (text_.compare(position_, word.size(), word) != 0)
+      return false;
+    position_ += word.size();
+    return true;
+  }
+
+  std::string parse_string() {
+    expect('"');
+    std::string res;
+    while (position_ < text_.size() && text_[position_] != '"') {
+      if (text_[position_] == '\\' && position_ + 1 < text_.size())
+        position_++;
+      res += text_[position_++];
+    }
+    if (position_ == text_.size())
+      throw_error("Unterminated string");
+    position_++;
+    return res;
+  }
+
+  JsonValue parse_value() {
+    skip_spaces();
+    if (position_ == text_.size())
+      throw_error("Unexpected end");
+    JsonValue value;
+    const char symbol = text_[position_];
+    if (symbol == '{') {
+      value.type = JsonValue::Type::Object;
+      position_++;
+      if (consume('}'))
+        return value;
+      do {
+        skip_spaces();
+        auto key = parse_string();
+        expect(':');
+        value.object.emplace_back(std::move(key), parse_value());
+      } while (consume(','));
+      expect('}');
+    } else if (symbol == '[') {
+      value.type = JsonValue::Type::Array;
+      position_++;
+      if (consume(']'))
+        return value;
+      do {
+        value.array.push_back(parse_value());
+      } while (consume(','));
+      expect(']');
+    } else if (symbol == '"') {
+      value.type = JsonValue::Type::String;
+      value.string = parse_string();
+    } else if (consume_word("true") || consume_word("false")) {
+      value.type = JsonValue::Type::Bool;
+      value.boolean = symbol == 't';
+    } else if (consume_word("null")) {
+      value.type = JsonValue::Type::Null;
+    } else {
+      value.type = JsonValue::Type::Number;
+      size_t length = 0;
+      try {
+        value.number = std::stod(text_.substr(position_, 32), &length);
+      } catch (const std::exception&) {
+        throw_error("Bad value");
+      }
+      position_ += length;
+    }
+    return value;
+  }
+};
+
+JsonValue read_json(const std::string& file_path) {
+  std::ifstream file(file_path);
+  if (!file)
+    throw std::invalid_argument("Cant open '" + file_path + "'");
+  std::stringstream text;
+  text << file.rdbuf();
+  const auto content = text.str();
+  try {
+    return JsonParser(content).parse();
+  } catch (const std::invalid_argument& exception) {
+    throw std::invalid_argument(file_path + ": " + exception.what());
+  }
+}
+
+std::string get_element_label(const JsonValue& element, int index) {
+  if (const auto* name = element.find("name");
+      name != nullptr && name->type == JsonValue::Type::String)
+    return name->string;
+  std::string label;
+  for (const auto& key : CELL_KEYS)
+    if (const auto* value = element.find(key);
+        value != nullptr && value->type == JsonValue::Type::Number) {
+      std::ostringstream number;
+      number << value->number;
+      label += (label.empty() ? "" : ",") + key + "=" + number.str();
+    }
+  return label.empty() ? std::to_string(index) : label;
+}
+
+// every object holding samples, keyed by its path
+void collect_metrics(const JsonValue& value,
+                     const std::string& path,
+                     std::map<std::string, std::vector<double>>& metrics) {
+  if (value.type == JsonValue::Type::Object) {
+    const auto* samples = value.find("samples");
+    if (samples != nullptr && samples->type == JsonValue::Type::Array) {
+      auto& metric = metrics[path];
+      for (const auto& sample : samples->array)
+        if (sample.type == JsonValue::Type::Number)
+          metric.push_back(sample.number);
+    }
+    for (const auto& [key, child] : value.object)
+      collect_metrics(child, path.empty() ? key : path + "/" + key, metrics);
+  } else if (value.type == JsonValue::Type::Array) {
+    for (int i = 0; i < static_cast<int>(value.array.size()); i++)
+      collect_metrics(value.array[i],
+                      path + "[" + get_element_label(value.array[i], i) + "]",
+                      metrics);
+  }
+}
+
+double get_median(std::vector<double> values) {
+  std::sort(values.begin(), values.end());
+  const size_t middle = values.size() / 2;
+  return values.size() % 2 ? values[middle]
+                           : (values[middle - 1] + values[middle]) / 2;
+}
+
+// probability that U of samples of sizes first_count and second_count is at
+// least u when both come from one distribution, counted over all orderings
+double get_exact_p_value(int first_count, int second_count, double u) {
+  // ways[n][k] orderings of first n and all second samples with U = k, built
+  // one second sample at a time
+  const int max_u = first_count * second_count;
+  std::vector<std::vector<double>> ways(
+      first_count + 1, std::vector<double>(max_u + 1, 0));
+  for (int n = 0; n <= first_count; n++)
+    ways[n][0] = 1;
+  for (int m = 1; m <= second_count; m++) {
+    auto next_ways = std::vector<std::vector<double>>(
+        first_count + 1, std::vector<double>(max_u + 1, 0));
+    next_ways[0][0] = 1;
+    for (int n = 1; n <= first_count; n++)
+      for (int k = 0; k <= n * m; k++) {
+        // the largest sample is either from the first set, adding m to U,
+        // or from the second one
+        next_ways[n][k] = ways[n][k] + (k >= m ? next_ways[n - 1][k - m] : 0);
+      }
+    ways = std::move(next_ways);
+  }
+  double total = 0;
+  double at_least = 0;
+  for (int k = 0; k <= max_u; k++) {
+    total += ways[first_count][k];
+    if (k >= u - 1e-9)
+      at_least += ways[first_count][k];
+  }
+  return at_least / total;
+}
+
+// one-sided Mann-Whitney U test that candidate samples tend to be larger
+double get_p_value(const std::vector<double>& baseline,
+                   const std::vector<double>& candidate) {
+  std::vector<std::pair<double, bool>> values;
+  for (const double value : baseline)
+    values.emplace_back(value, false);
+  for (const double value : candidate)
+    values.emplace_back(value, true);
+  std::sort(values.begin(), values.end());
+
+  // average ranks over ties
+  double candidate_rank_sum = 0;
+  double ties_correction = 0;
+  bool has_ties = false;
+  for (size_t begin = 0; begin < values.size();) {
+    size_t end = begin;
+    while (end < values.size() && values[end].first == values[begin].first)
+      end++;
+    const double rank = (begin + 1 + end) / 2.0;
+    for (size_t i = begin; i < end; i++)
+      if (values[i].second)
+        candidate_rank_sum += rank;
+    const double ties_count = end - begin;
+    ties_correction += ties_count * ties_count * ties_count - ties_count;
+    has_ties = has_ties || ties_count > 1;
+    begin = end;
+  }
+
+  const double n1 = candidate.size();
+  const double n2 = baseline.size();
+  const double u = candidate_rank_sum - n1 * (n1 + 1) / 2;
+  if (!has_ties && n1 * n2 <= MAX_EXACT_PAIRS_COUNT)
+    return get_exact_p_value(candidate.size(), baseline.size(), u);
+
+  const double count = n1 + n2;
+  const double variance =
+      n1 * n2 / 12 * (count + 1 - ties_correction / (count * (count - 1)));
+  if (variance <= 0)
+    return 1;
+  // continuity corrected
+  const double z = (u - n1 * n2 / 2 - 0.5) / std::sqrt(variance);
+  return 0.5 * std::erfc(z / std::sqrt(2.0));
+}
+
+struct Options {
+  std::string baseline_path;
+  std::string candidate_path;
+  double alpha = 0.05;
+  double threshold = 0.05;
+};
+
+Options parse_options(int argc, char** argv) {
+  Options options;
+  std::vector<std::string> paths;
+  for (int i = 1; i < argc; i++) {
+    const std::string arg = argv[i];
+    if (arg.rfind("--", 0) != 0) {
+      paths.push_back(arg);
+      continue;
+    }
+    if (i + 1 == argc)
+      throw std::invalid_argument("No value given for '" + arg + "'");
+    const double value = std::stod(argv[++i]);
+    if (arg == "--alpha")
+      options.alpha = value;
+    else if (arg == "--threshold")
+      options.threshold = value;
+    else
+      throw std::invalid_argument("Unknown parameter '" + arg + "'");
+  }
+  if (paths.size() != 2)
+    throw std::invalid_argument("Expected baseline and candidate files");
+  options.baseline_path = paths[0];
+  options.candidate_path = paths[1];
+  return options;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  Options options;
+  std::map<std::string, std::vector<double>> baseline_metrics;
+  std::map<std::string, std::vector<double>> candidate_metrics;
+  try {
+    options = parse_options(argc, argv);
+    collect_metrics(read_json(options.baseline_path), "", baseline_metrics);
+    collect_metrics(read_json(options.candidate_path), "", candidate_metrics);
+  } catch (const std::exception& exception) {
+    std::cerr << exception.what() << std::endl;
+    return 2;
+  }
+
+  int regressions_count = 0;
+  for (const auto& [metric, baseline] : baseline_metrics) {
+    const auto candidate_it = candidate_metrics.find(metric);
+    if (candidate_it == candidate_metrics.end() ||
+        candidate_it->second.empty() || baseline.empty()) {
+      std::cout << "missing      " << metric << "\n";
+      continue;
+    }
+    const auto& candidate = candidate_it->second;
+    const double baseline_median = get_median(baseline);
+    const double candidate_median = get_median(candidate);
+    const double delta = baseline_median > 0
+                             ? candidate_median / baseline_median - 1
+                             : 0;
+    const double slower_p_value = get_p_value(baseline, candidate);
+    const double faster_p_value = get_p_value(candidate, baseline);
+
+    std::string verdict = "unchanged   ";
+    if (slower_p_value < options.alpha && delta > options.threshold) {
+      verdict = "REGRESSION  ";
+      regressions_count++;
+    } else if (faster_p_value < options.alpha && -delta > options.threshold) {
+      verdict = "improvement ";
+    }
+    char numbers[128];
+    std::snprintf(numbers, sizeof(numbers),
+                  "%+7.2f%%  p=%.4f  median %.4g -> %.4g  ", delta * 100,
+                  std::min(slower_p_value, faster_p_value), baseline_median,
+                  candidate_median);
+    std::cout << verdict << numbers << metric << "\n";
+  }
+  for (const auto& [metric, candidate] : candidate_metrics)
+    if (baseline_metrics.find(metric) == baseline_metrics.end())
+      std::cout << "new          " << metric << "\n";
+
+  std::cout << regressions_count << " regression(s) of "
+            << baseline_metrics.size() << " metric(s)" << std::endl;
+  return regressions_count > 0 ? 1 : 0;
+}
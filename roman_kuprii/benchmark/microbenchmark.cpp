@@ -0,0 +1,440 @@
+// times the Graph primitives generation is made of, on seeded graphs of
+// every size, branching and degree distribution of the matrix, and prints
+// nanoseconds per operation as json.
+//
+//   microbenchmark --vertices 1000,100000 --branching 2,8
+//                  --distributions uniform,skewed --repetitions 5
+//                  [--output f]
+//
+// every case runs a fixed number of operations, so results of two builds are
+// comparable case by case. Besides the Graph the snapshot runs the read
+// operations it supports
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "../graph.hpp"
+#include "../graph_snapshot.hpp"
+
+namespace {
+
+using uni_cpp_practice::EdgeColor;
+using uni_cpp_practice::Graph;
+using uni_cpp_practice::GraphSnapshot;
+
+constexpr int SEED = 1;
+// colored edges added on top of the tree, per vertex
+constexpr double EXTRA_EDGES_PER_VERTEX = 0.5;
+// small graphs run out of unconnected pairs, then fewer edges are added
+constexpr int MAX_ATTEMPTS_PER_EDGE = 20;
+// query counts of the read operations, fixed so they dont vary with the size
+constexpr int IS_CONNECTED_QUERIES_COUNT = 1000000;
+constexpr int DEPTH_QUERIES_COUNT = 1000000;
+constexpr int COLOR_QUERIES_COUNT = 1000;
+
+const std::vector<EdgeColor> COLORS = {EdgeColor::Gray, EdgeColor::Green,
+                                       EdgeColor::Blue, EdgeColor::Yellow,
+                                       EdgeColor::Red};
+
+struct Options {
+  std::vector<int> vertices_counts = {1000, 100000};
+  std::vector<int> branchings = {2, 8};
+  std::vector<std::string> distributions = {"uniform", "skewed"};
+  int repetitions = 5;
+  std::string output_path;
+};
+
+std::vector<std::string> split(const std::string& text) {
+  std::vector<std::string> parts;
+  std::stringstream stream(text);
+  std::string part;
+  while (std::getline(stream, part, ','))
+    parts.push_back(part);
+  if (parts.empty())
+    throw std::invalid_argument("No values given in '" + text + "'");
+  return parts;
+}
+
+std::vector<int> to_ints(const std::vector<std::string>& values) {
+  std::vector<int> res;
+  for (const auto& value : values)
+    res.push_back(std::stoi(value));
+  return res;
+}
+
+Options parse_options(int argc, char** argv) {
+  Options options;
+  for (int i = 1; i < argc; i += 2) {
+    const std::string flag = argv[i];
+    if (flag.rfind("--", 0) != 0 || i + 1 == argc)
+      throw std::invalid_argument("Expected '--key value', got '" + flag +
+                                  "'");
+    const std::string key = flag.substr(2);
+    const std::string value = argv[i + 1];
+    if (key == "vertices")
+      options.vertices_counts = to_ints(split(value));
+    else if (key == "branching")
+      options.branchings = to_ints(split(value));
+    else if (key == "distributions")
+      options.distributions = split(value);
+    else if (key == "repetitions")
+      options.repetitions = std::stoi(value);
+    else if (key == "output")
+      options.output_path = value;
+    else
+      throw std::invalid_argument("Unknown parameter '" + key + "'");
+  }
+  for (const auto& distribution : options.distributions)
+    if (distribution != "uniform" && distribution != "skewed")
+      throw std::invalid_argument("Unknown distribution '" + distribution +
+                                  "'");
+  if (options.repetitions < 1)
+    throw std::invalid_argument("Need at least one repetition");
+  return options;
+}
+
+// vertex and edge order of a generated graph: every vertex joins its parent
+// by a gray edge, then colored edges follow
+struct Workload {
+  std::vector<int> parent_ids;
+  std::vector<std::pair<int, int>> extra_edges;
+  // half of them connected pairs, half random ones
+  std::vector<std::pair<int, int>> is_connected_queries;
+
+  int get_edges_count() const {
+    return parent_ids.size() - 1 + extra_edges.size();
+  }
+};
+
+uint64_t get_pair_key(int first_id, int second_id) {
+  const auto [min_id, max_id] = std::minmax(first_id, second_id);
+  return (static_cast<uint64_t>(min_id) << 32) | static_cast<uint32_t>(max_id);
+}
+
+// uniform trees give every vertex branching children, skewed ones draw
+// parents biased towards the oldest vertices, which become hubs, the more
+// the larger branching is
+Workload make_workload(int vertices_count,
+                       int branching,
+                       const std::string& distribution) {
+  std::mt19937 random(SEED);
+  std::uniform_real_distribution<> probability(0, 1);
+  Workload workload;
+  std::unordered_set<uint64_t> connected_pairs;
+  workload.parent_ids.push_back(-1);
+  for (int vertex_id = 1; vertex_id < vertices_count; vertex_id++) {
+    const int parent_id =
+        distribution == "uniform"
+            ? (vertex_id - 1) / branching
+            : static_cast<int>(std::pow(probability(random), branching) *
+                               vertex_id);
+    workload.parent_ids.push_back(parent_id);
+    connected_pairs.insert(get_pair_key(parent_id, vertex_id));
+  }
+
+  // green, blue, yellow and red edges, to the same vertex or to one that is
+  // zero, one or two levels deeper, as the generator paints them
+  std::vector<int> depths(vertices_count, 0);
+  std::vector<std::vector<int>> vertex_ids_at_depth = {{0}};
+  for (int vertex_id = 1; vertex_id < vertices_count; vertex_id++) {
+    depths[vertex_id] = depths[workload.parent_ids[vertex_id]] + 1;
+    if (depths[vertex_id] == static_cast<int>(vertex_ids_at_depth.size()))
+      vertex_ids_at_depth.emplace_back();
+    vertex_ids_at_depth[depths[vertex_id]].push_back(vertex_id);
+  }
+  std::uniform_int_distribution<> vertex_id(0, vertices_count - 1);
+  std::uniform_int_distribution<> depth_diff(-1, 2);
+  const int extra_edges_count = EXTRA_EDGES_PER_VERTEX * vertices_count;
+  for (int attempt = 0;
+       attempt < MAX_ATTEMPTS_PER_EDGE * extra_edges_count &&
+       static_cast<int>(workload.extra_edges.size()) < extra_edges_count;
+       attempt++) {
+    const int from_id = vertex_id(random);
+    // -1 stands for the vertex itself
+    const int diff = depth_diff(random);
+    const int to_depth = depths[from_id] + std::max(diff, 0);
+    if (to_depth >= static_cast<int>(vertex_ids_at_depth.size()))
+      continue;
+    const auto& candidate_ids = vertex_ids_at_depth[to_depth];
+    const int to_id =
+        diff == -1 ? from_id
+                   : candidate_ids[std::uniform_int_distribution<>(
+                         0, candidate_ids.size() - 1)(random)];
+    if (diff == 0 && to_id == from_id)
+      continue;
+    if (connected_pairs.insert(get_pair_key(from_id, to_id)).second)
+      workload.extra_edges.emplace_back(from_id, to_id);
+  }
+
+  for (int i = 0; i < IS_CONNECTED_QUERIES_COUNT; i++)
+    if (i % 2 == 0 && vertices_count > 1) {
+      const int child_id = 1 + i / 2 % (vertices_count - 1);
+      workload.is_connected_queries.emplace_back(
+          workload.parent_ids[child_id], child_id);
+    } else {
+      workload.is_connected_queries.emplace_back(vertex_id(random),
+                                                 vertex_id(random));
+    }
+  return workload;
+}
+
+void fill_graph(Graph& graph, const Workload& workload) {
+  const int vertices_count = static_cast<int>(workload.parent_ids.size());
+  for (int i = 0; i < vertices_count; i++)
+    graph.add_vertex();
+  for (int vertex_id = 1; vertex_id < vertices_count; vertex_id++)
+    graph.connect_vertices(workload.parent_ids[vertex_id], vertex_id);
+  for (const auto& [from_id, to_id] : workload.extra_edges)
+    graph.connect_vertices(from_id, to_id);
+}
+
+double measure_seconds(const std::function<void()>& job) {
+  const auto start = std::chrono::steady_clock::now();
+  job();
+  const std::chrono::duration<double> duration =
+      std::chrono::steady_clock::now() - start;
+  return duration.count();
+}
+
+// keeps the results of read operations alive, so they arent optimized away
+volatile uint64_t sink = 0;
+
+struct Case {
+  std::string operation;
+  std::string graph;
+  int vertices_count = 0;
+  int branching = 0;
+  std::string distribution;
+  uint64_t operations_count = 0;
+  // one job call runs operations_count operations, the rest is untimed
+  std::function<void()> prepare;
+  std::function<void()> job;
+};
+
+struct Result {
+  std::string name;
+  const Case* bench_case = nullptr;
+  std::vector<double> nanoseconds_per_operation;
+};
+
+// cases of every operation of the graph
+void add_graph_cases(std::vector<Case>& cases,
+                     const Workload& workload,
+                     const Case& base_case) {
+  // rebuilt by prepare() before each write repetition, the read cases use
+  // the last one built
+  auto graph = std::make_shared<std::unique_ptr<Graph>>();
+  const auto rebuild = [graph, &workload]() {
+    *graph = std::make_unique<Graph>();
+    fill_graph(**graph, workload);
+  };
+
+  Case add_vertex = base_case;
+  add_vertex.operation = "add_vertex";
+  add_vertex.graph = "graph";
+  add_vertex.operations_count = workload.parent_ids.size();
+  add_vertex.prepare = [graph]() { *graph = std::make_unique<Graph>(); };
+  add_vertex.job = [graph, &workload]() {
+    for (int i = 0; i < static_cast<int>(workload.parent_ids.size()); i++)
+      (*graph)->add_vertex();
+  };
+  cases.push_back(add_vertex);
+
+  Case connect_vertices = base_case;
+  connect_vertices.operation = "connect_vertices";
+  connect_vertices.graph = "graph";
+  connect_vertices.operations_count = workload.get_edges_count();
+  connect_vertices.prepare = [graph, &workload]() {
+    *graph = std::make_unique<Graph>();
+    for (int i = 0; i < static_cast<int>(workload.parent_ids.size()); i++)
+      (*graph)->add_vertex();
+  };
+  connect_vertices.job = [graph, &workload]() {
+    for (int vertex_id = 1;
+         vertex_id < static_cast<int>(workload.parent_ids.size());
+         vertex_id++)
+      (*graph)->connect_vertices(workload.parent_ids[vertex_id], vertex_id);
+    for (const auto& [from_id, to_id] : workload.extra_edges)
+      (*graph)->connect_vertices(from_id, to_id);
+  };
+  cases.push_back(connect_vertices);
+
+  Case is_connected = base_case;
+  is_connected.operation = "is_connected";
+  is_connected.graph = "graph";
+  is_connected.operations_count = workload.is_connected_queries.size();
+  is_connected.prepare = rebuild;
+  is_connected.job = [graph, &workload]() {
+    uint64_t connected_count = 0;
+    for (const auto& [from_id, to_id] : workload.is_connected_queries)
+      connected_count += (*graph)->is_connected(from_id, to_id);
+    sink = connected_count;
+  };
+  cases.push_back(is_connected);
+
+  Case vertex_ids_at_depth = base_case;
+  vertex_ids_at_depth.operation = "get_vertex_ids_at_depth";
+  vertex_ids_at_depth.graph = "graph";
+  vertex_ids_at_depth.operations_count = DEPTH_QUERIES_COUNT;
+  vertex_ids_at_depth.prepare = rebuild;
+  vertex_ids_at_depth.job = [graph]() {
+    const int depth = (*graph)->get_depth();
+    uint64_t vertices_count = 0;
+    for (int i = 0; i < DEPTH_QUERIES_COUNT; i++)
+      vertices_count += (*graph)->get_vertex_ids_at_depth(i % (depth + 1))
+                            .size();
+    sink = vertices_count;
+  };
+  cases.push_back(vertex_ids_at_depth);
+
+  Case edge_ids_with_color = base_case;
+  edge_ids_with_color.operation = "get_edge_ids_with_color";
+  edge_ids_with_color.graph = "graph";
+  edge_ids_with_color.operations_count = COLOR_QUERIES_COUNT;
+  edge_ids_with_color.prepare = rebuild;
+  // the ids are walked, as the paint passes and printing do
+  edge_ids_with_color.job = [graph]() {
+    uint64_t ids_sum = 0;
+    for (int i = 0; i < COLOR_QUERIES_COUNT; i++)
+      for (const auto& edge_id :
+           (*graph)->get_edge_ids_with_color(COLORS[i % COLORS.size()]))
+        ids_sum += edge_id;
+    sink = ids_sum;
+  };
+  cases.push_back(edge_ids_with_color);
+}
+
+// read operations over the frozen graph
+void add_vector_cases(std::vector<Case>& cases,
+                      const Workload& workload,
+                      const Case& base_case) {
+  auto graph = std::make_shared<std::unique_ptr<Graph>>();
+  auto snapshot = std::make_shared<std::unique_ptr<GraphSnapshot>>();
+  const auto rebuild = [graph, snapshot, &workload]() {
+    if (*snapshot)
+      return;
+    *graph = std::make_unique<Graph>();
+    fill_graph(**graph, workload);
+    *snapshot = std::make_unique<GraphSnapshot>(GraphSnapshot::freeze(**graph));
+  };
+
+  Case vertex_ids_at_depth = base_case;
+  vertex_ids_at_depth.operation = "get_vertex_ids_at_depth";
+  vertex_ids_at_depth.graph = "snapshot";
+  vertex_ids_at_depth.operations_count = DEPTH_QUERIES_COUNT;
+  vertex_ids_at_depth.prepare = rebuild;
+  vertex_ids_at_depth.job = [snapshot]() {
+    const int depth = (*snapshot)->get_depth();
+    uint64_t vertices_count = 0;
+    for (int i = 0; i < DEPTH_QUERIES_COUNT; i++)
+      vertices_count +=
+          (*snapshot)->get_vertex_ids_at_depth(i % (depth + 1)).size();
+    sink = vertices_count;
+  };
+  cases.push_back(vertex_ids_at_depth);
+}
+
+std::string get_case_name(const Case& bench_case) {
+  return bench_case.operation + "/" + bench_case.graph + "/" +
+         bench_case.distribution +
+         "/vertices=" + std::to_string(bench_case.vertices_count) +
+         "/branching=" + std::to_string(bench_case.branching);
+}
+
+std::string number_to_json(double number) {
+  std::ostringstream stream;
+  stream << number;
+  return stream.str();
+}
+
+std::string result_to_json(const Result& result) {
+  auto sorted = result.nanoseconds_per_operation;
+  std::sort(sorted.begin(), sorted.end());
+  const auto& bench_case = *result.bench_case;
+  std::string res = "    {";
+  res += "\"name\": \"" + result.name + "\", ";
+  res += "\"operation\": \"" + bench_case.operation + "\", ";
+  res += "\"graph\": \"" + bench_case.graph + "\", ";
+  res += "\"distribution\": \"" + bench_case.distribution + "\", ";
+  res += "\"vertices\": " + std::to_string(bench_case.vertices_count) + ", ";
+  res += "\"branching\": " + std::to_string(bench_case.branching) + ", ";
+  res += "\"operations\": " + std::to_string(bench_case.operations_count) +
+         ", ";
+  res += "\"ns_per_op\": {\"min\": " + number_to_json(sorted.front()) +
+         ", \"p50\": " + number_to_json(sorted[(sorted.size() - 1) / 2]) +
+         ", \"max\": " + number_to_json(sorted.back()) + ", \"samples\": [";
+  for (int i = 0;
+       i < static_cast<int>(result.nanoseconds_per_operation.size()); i++)
+    res += (i > 0 ? ", " : "") +
+           number_to_json(result.nanoseconds_per_operation[i]);
+  res += "]}}";
+  return res;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  Options options;
+  try {
+    options = parse_options(argc, argv);
+  } catch (const std::exception& exception) {
+    std::cerr << exception.what() << std::endl;
+    return 1;
+  }
+
+  std::string res = "{\n  \"results\": [\n";
+  bool is_first = true;
+  for (const int vertices_count : options.vertices_counts)
+    for (const int branching : options.branchings)
+      for (const auto& distribution : options.distributions) {
+        const auto workload =
+            make_workload(vertices_count, branching, distribution);
+        Case base_case;
+        base_case.vertices_count = vertices_count;
+        base_case.branching = branching;
+        base_case.distribution = distribution;
+
+        std::vector<Case> cases;
+        add_graph_cases(cases, workload, base_case);
+        add_vector_cases(cases, workload, base_case);
+
+        for (const auto& bench_case : cases) {
+          Result result;
+          result.name = get_case_name(bench_case);
+          result.bench_case = &bench_case;
+          // one warmup run first
+          for (int repetition = 0; repetition <= options.repetitions;
+               repetition++) {
+            bench_case.prepare();
+            const double seconds = measure_seconds(bench_case.job);
+            if (repetition > 0)
+              result.nanoseconds_per_operation.push_back(
+                  seconds * 1e9 / bench_case.operations_count);
+          }
+          res += std::string(is_first ? "" : ",\n") + result_to_json(result);
+          is_first = false;
+        }
+      }
+  res += "\n  ]\n}\n";
+
+  if (options.output_path.empty()) {
+    std::cout << res;
+  } else {
+    std::ofstream out(options.output_path, std::ofstream::trunc);
+    out << res;
+  }
+  return 0;
+}
@@ -0,0 +1,144 @@
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <string>
+#include <vector>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#define PERF_COUNTERS_HAS_PERF_EVENT
+#endif
+
+#include "perf_counters.hpp"
+
+namespace uni_cpp_practice {
+
+namespace perf_counters {
+
+#if defined(PERF_COUNTERS_HAS_PERF_EVENT)
+
+namespace {
+
+struct CounterConfig {
+  const char* name;
+  uint32_t type;
+  uint64_t config;
+};
+
+constexpr uint64_t get_cache_config(uint64_t cache, uint64_t result) {
+  return cache | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (result << 16);
+}
+
+// the first one leads the group
+const std::vector<CounterConfig> COUNTER_CONFIGS = {
+    {"cycles", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+    {"instructions", PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+    {"llc_misses", PERF_TYPE_HW_CACHE,
+     get_cache_config(PERF_COUNT_HW_CACHE_LL,
+                      PERF_COUNT_HW_CACHE_RESULT_MISS)},
+    {"dtlb_misses", PERF_TYPE_HW_CACHE,
+     get_cache_config(PERF_COUNT_HW_CACHE_DTLB,
+                      PERF_COUNT_HW_CACHE_RESULT_MISS)},
+    {"branch_misses", PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+};
+
+// value, time enabled and time running of one counter
+struct ReadFormat {
+  uint64_t value = 0;
+  uint64_t time_enabled = 0;
+  uint64_t time_running = 0;
+};
+
+int open_counter(const CounterConfig& counter_config, int group_fd) {
+  perf_event_attr attr;
+  std::memset(&attr, 0, sizeof(attr));
+  attr.size = sizeof(attr);
+  attr.type = counter_config.type;
+  attr.config = counter_config.config;
+  attr.disabled = group_fd == -1 ? 1 : 0;
+  // counts the worker threads started during the phase as well, so every
+  // counter is read on its own, group reads dont support inherited counts
+  attr.inherit = 1;
+  attr.exclude_kernel = 1;
+  attr.exclude_hv = 1;
+  attr.read_format =
+      PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+  return syscall(SYS_perf_event_open, &attr, 0, -1, group_fd, 0);
+}
+
+}  // namespace
+
+CounterGroup::CounterGroup() {
+  int group_fd = -1;
+  for (const auto& counter_config : COUNTER_CONFIGS) {
+    const int file_descriptor = open_counter(counter_config, group_fd);
+    if (file_descriptor == -1) {
+      if (!error_.empty())
+        error_ += ", ";
+      error_ += std::string(counter_config.name) + ": " + std::strerror(errno);
+      // members cant be opened without a leader
+      if (group_fd == -1)
+        return;
+      continue;
+    }
+    if (group_fd == -1)
+      group_fd = file_descriptor;
+    counters_.push_back({counter_config.name, file_descriptor});
+  }
+}
+
+CounterGroup::~CounterGroup() {
+  // members before the leader
+  for (auto counter = counters_.rbegin(); counter != counters_.rend();
+       counter++)
+    close(counter->file_descriptor);
+}
+
+void CounterGroup::start() {
+  if (!is_available())
+    return;
+  const int group_fd = counters_.front().file_descriptor;
+  ioctl(group_fd, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+  ioctl(group_fd, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+}
+
+std::map<std::string, double> CounterGroup::stop() {
+  std::map<std::string, double> res;
+  if (!is_available())
+    return res;
+  ioctl(counters_.front().file_descriptor, PERF_EVENT_IOC_DISABLE,
+        PERF_IOC_FLAG_GROUP);
+  for (const auto& counter : counters_) {
+    ReadFormat read_format;
+    if (read(counter.file_descriptor, &read_format, sizeof(read_format)) !=
+            sizeof(read_format) ||
+        read_format.time_running == 0)
+      continue;
+    res[counter.name] = static_cast<double>(read_format.value) *
+                        static_cast<double>(read_format.time_enabled) /
+                        static_cast<double>(read_format.time_running);
+  }
+  return res;
+}
+
+#else
+
+CounterGroup::CounterGroup() : error_("perf_event_open needs linux") {}
+
+CounterGroup::~CounterGroup() {}
+
+void CounterGroup::start() {}
+
+std::map<std::string, double> CounterGroup::stop() {
+  return {};
+}
+
+#endif
+
+}  // namespace perf_counters
+
+}  // namespace uni_cpp_practice
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace uni_cpp_practice {
+
+namespace perf_counters {
+
+// hardware counters of the calling process and the threads it starts while
+// counting, opened as one group so they are scheduled together. Counters the
+// cpu or the kernel refuse are left out, without any the group is unavailable
+class CounterGroup {
+ public:
+  CounterGroup();
+  ~CounterGroup();
+
+  CounterGroup(const CounterGroup&) = delete;
+  CounterGroup& operator=(const CounterGroup&) = delete;
+
+  bool is_available() const { return !counters_.empty(); }
+  // why counters were refused, empty when all of them are open
+  const std::string& get_error() const { return error_; }
+
+  void start();
+  // counter name to its value since start(), scaled up when the kernel had
+  // to multiplex the counters
+  std::map<std::string, double> stop();
+
+ private:
+  struct Counter {
+    std::string name;
+    int file_descriptor = -1;
+  };
+
+  std::vector<Counter> counters_;
+  std::string error_;
+};
+
+}  // namespace perf_counters
+
+}  // namespace uni_cpp_practice
@@ -1,4 +1,9 @@
+#include <algorithm>
 #include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
 #include <stdexcept>
 #include <string>
 #include <unordered_map>
@@ -8,38 +13,54 @@
 
 namespace {
 
-bool is_edge_id_included(
-    const uni_cpp_practice::EdgeId& id,
-    const std::vector<uni_cpp_practice::EdgeId>& edge_ids) {
+bool is_edge_id_included(const uni_cpp_practice::EdgeId& id,
+                         const uni_cpp_practice::VertexEdgeIds& edge_ids) {
   for (const auto& edge_id : edge_ids)
     if (id == edge_id)
       return true;
   return false;
 }
 
-uni_cpp_practice::Edge::Color calculate_edge_color(
+uni_cpp_practice::EdgeColor calculate_edge_color(
     const uni_cpp_practice::Vertex& from_vertex,
     const uni_cpp_practice::Vertex& to_vertex) {
   const int depth_diff = to_vertex.depth - from_vertex.depth;
   if (from_vertex.get_id() == to_vertex.get_id())
-    return uni_cpp_practice::Edge::Color::Green;
+    return uni_cpp_practice::EdgeColor::Green;
   else if (to_vertex.depth == 0)
-    return uni_cpp_practice::Edge::Color::Gray;
+    return uni_cpp_practice::EdgeColor::Gray;
   else if (depth_diff == 0)
-    return uni_cpp_practice::Edge::Color::Blue;
+    return uni_cpp_practice::EdgeColor::Blue;
   else if (depth_diff == 1)
-    return uni_cpp_practice::Edge::Color::Yellow;
+    return uni_cpp_practice::EdgeColor::Yellow;
   else if (depth_diff == 2)
-    return uni_cpp_practice::Edge::Color::Red;
+    return uni_cpp_practice::EdgeColor::Red;
   else
-    return uni_cpp_practice::Edge::Color::Gray;
+    return uni_cpp_practice::EdgeColor::Gray;
 
   throw std::logic_error("Cant calculate color");
 }
 
-using std::min;
-using std::to_string;
-using std::vector;
+uint64_t get_adjacency_key(const uni_cpp_practice::VertexId& first_vertex_id,
+                           const uni_cpp_practice::VertexId& second_vertex_id) {
+  const auto [min_vertex_id, max_vertex_id] =
+      std::minmax(first_vertex_id, second_vertex_id);
+  return (static_cast<uint64_t>(static_cast<uint32_t>(min_vertex_id)) << 32) |
+         static_cast<uint32_t>(max_vertex_id);
+}
+
+// buckets plus one node per element, holding the value and the next pointer
+template <typename HashContainer>
+size_t get_hash_container_memory_usage(const HashContainer& container) {
+  using Value = typename HashContainer::value_type;
+  return container.bucket_count() * sizeof(void*) +
+         container.size() * (sizeof(Value) + sizeof(void*));
+}
+
+template <typename Vector>
+size_t get_vector_memory_usage(const Vector& vector) {
+  return vector.capacity() * sizeof(typename Vector::value_type);
+}
 
 }  // namespace
 
@@ -50,16 +71,77 @@ void Vertex::add_edge_id(const EdgeId& _id) {
   edges_ids_.push_back(_id);
 }
 
+Graph::Graph(std::pmr::memory_resource* memory_resource,
+             std::shared_ptr<void> memory_owner)
+    : memory_owner_(std::move(memory_owner)),
+      vertices_(memory_resource),
+      edges_(memory_resource),
+      adjacency_(memory_resource),
+      color_edges_map_({std::pmr::vector<EdgeId>(memory_resource),
+                        std::pmr::vector<EdgeId>(memory_resource),
+                        std::pmr::vector<EdgeId>(memory_resource),
+                        std::pmr::vector<EdgeId>(memory_resource),
+                        std::pmr::vector<EdgeId>(memory_resource)}),
+      depth_map_(memory_resource),
+      depth_map_positions_(memory_resource) {}
+
 VertexId Graph::add_vertex() {
   const VertexId new_vertex_id = get_next_vertex_id();
   vertices_.emplace(new_vertex_id, new_vertex_id);
   if (depth_map_.empty())
-    depth_map_.push_back({new_vertex_id});
-  else
-    depth_map_[0].push_back(new_vertex_id);
+    depth_map_.emplace_back();
+  depth_map_[0].push_back(new_vertex_id);
+  depth_map_positions_.push_back(depth_map_[0].size() - 1);
+  depth_ = std::max(depth_, 0);
   return new_vertex_id;
 }
 
+void Graph::move_vertex_to_depth(const VertexId& vertex_id, int new_depth) {
+  auto& vertex = vertices_.at(vertex_id);
+  // swap with the last vertex of the bucket, so the removal is O(1)
+  auto& old_depth_vertex_ids = depth_map_[vertex.depth];
+  const int position = depth_map_positions_[vertex_id];
+  const VertexId last_vertex_id = old_depth_vertex_ids.back();
+  old_depth_vertex_ids[position] = last_vertex_id;
+  depth_map_positions_[last_vertex_id] = position;
+  old_depth_vertex_ids.pop_back();
+
+  vertex.depth = new_depth;
+  if (new_depth == static_cast<int>(depth_map_.size()))
+    depth_map_.emplace_back();
+  depth_map_[new_depth].push_back(vertex_id);
+  depth_map_positions_[vertex_id] = depth_map_[new_depth].size() - 1;
+  depth_ = std::max(depth_, new_depth);
+}
+
+void Graph::reserve(int vertices_count,
+                    int edges_count,
+                    const std::vector<int>& vertices_count_per_depth) {
+  vertices_.reserve(vertices_count);
+  depth_map_positions_.reserve(vertices_count);
+  edges_.reserve(edges_count);
+  adjacency_.reserve(edges_count);
+  if (depth_map_.size() < vertices_count_per_depth.size())
+    depth_map_.resize(vertices_count_per_depth.size());
+  for (int depth = 0; depth < static_cast<int>(vertices_count_per_depth.size());
+       depth++)
+    depth_map_[depth].reserve(vertices_count_per_depth[depth]);
+}
+
+void Graph::clear() {
+  vertices_.clear();
+  edges_.clear();
+  adjacency_.clear();
+  for (auto& edge_ids : color_edges_map_)
+    edge_ids.clear();
+  for (auto& vertex_ids : depth_map_)
+    vertex_ids.clear();
+  depth_ = -1;
+  depth_map_positions_.clear();
+  vertex_id_counter_ = 0;
+  edge_id_counter_ = 0;
+}
+
 bool Graph::is_vertex_exist(const VertexId& vertex_id) const {
   return vertices_.find(vertex_id) != vertices_.end();
 }
@@ -69,21 +151,8 @@ bool Graph::is_connected(const VertexId& from_vertex_id,
   assert(is_vertex_exist(from_vertex_id));
   assert(is_vertex_exist(to_vertex_id));
 
-  const auto& from_vertex_edges_ids =
-      vertices_.at(from_vertex_id).get_edges_ids();
-  const auto& to_vertex_edges_ids = vertices_.at(to_vertex_id).get_edges_ids();
-  for (const auto& from_vertex_edge_id : from_vertex_edges_ids)
-    if (from_vertex_id == to_vertex_id) {
-      const auto& connected_vertices =
-          edges_.at(from_vertex_edge_id).connected_vertices;
-      if (connected_vertices[0] == connected_vertices[1])
-        return true;
-    } else
-      for (const auto& to_vertex_edge_id : to_vertex_edges_ids)
-        if (from_vertex_edge_id == to_vertex_edge_id)
-          return true;
-
-  return false;
+  return adjacency_.find(get_adjacency_key(from_vertex_id, to_vertex_id)) !=
+         adjacency_.end();
 }
 
 void Graph::connect_vertices(const VertexId& from_vertex_id,
@@ -92,47 +161,45 @@ void Graph::connect_vertices(const VertexId& from_vertex_id,
   assert(is_vertex_exist(to_vertex_id));
   assert(!is_connected(from_vertex_id, to_vertex_id));
 
-  const Edge::Color color = calculate_edge_color(vertices_.at(from_vertex_id),
-                                                 vertices_.at(to_vertex_id));
+  const EdgeColor color = calculate_edge_color(vertices_.at(from_vertex_id),
+                                               vertices_.at(to_vertex_id));
 
-  if (color == Edge::Color::Gray) {
-    for (auto it = depth_map_[0].begin(); it != depth_map_[0].end(); it++)
-      if (*it == to_vertex_id) {
-        depth_map_[0].erase(it);
-        break;
-      }
-    const int new_depth = vertices_.at(from_vertex_id).depth + 1;
-    vertices_.at(to_vertex_id).depth = new_depth;
-
-    if (new_depth == depth_map_.size())
-      depth_map_.push_back(std::vector<VertexId>({to_vertex_id}));
-    else
-      depth_map_[new_depth].push_back(to_vertex_id);
-  }
+  if (color == EdgeColor::Gray)
+    move_vertex_to_depth(to_vertex_id, vertices_.at(from_vertex_id).depth + 1);
 
   const auto new_edge_id = get_next_edge_id();
 
   edges_.emplace(new_edge_id,
                  Edge(from_vertex_id, to_vertex_id, new_edge_id, color));
+  adjacency_.insert(get_adjacency_key(from_vertex_id, to_vertex_id));
+  color_edges_map_[static_cast<int>(color)].push_back(new_edge_id);
 
   vertices_.at(from_vertex_id).add_edge_id(new_edge_id);
   if (from_vertex_id != to_vertex_id)
     vertices_.at(to_vertex_id).add_edge_id(new_edge_id);
 }
 
-std::vector<EdgeId> Graph::get_edge_ids_with_color(
-    const Edge::Color& color) const {
-  std::vector<EdgeId> edge_ids;
-  for (const auto& [edge_id, edge] : get_edges()) {
-    if (edge.color == color)
-      edge_ids.emplace_back(edge_id);
-  }
-
-  return edge_ids;
+Graph::MemoryUsage Graph::memory_usage() const {
+  MemoryUsage memory_usage;
+  memory_usage.vertices = get_hash_container_memory_usage(vertices_);
+  for (const auto& [vertex_id, vertex] : vertices_)
+    if (!vertex.get_edges_ids().is_inline())
+      memory_usage.vertex_edge_lists +=
+          vertex.get_edges_ids().capacity() * sizeof(EdgeId);
+  memory_usage.edges = get_hash_container_memory_usage(edges_);
+  memory_usage.adjacency = get_hash_container_memory_usage(adjacency_);
+  for (const auto& edge_ids : color_edges_map_)
+    memory_usage.edge_columns += get_vector_memory_usage(edge_ids);
+  memory_usage.depth_map = get_vector_memory_usage(depth_map_) +
+                           get_vector_memory_usage(depth_map_positions_);
+  for (const auto& vertex_ids : depth_map_)
+    memory_usage.depth_map += get_vector_memory_usage(vertex_ids);
+  return memory_usage;
 }
 
-const std::vector<VertexId>& Graph::get_vertex_ids_at_depth(int depth) const {
-  assert(depth <= depth_map_.size());
+const std::pmr::vector<VertexId>& Graph::get_vertex_ids_at_depth(
+    int depth) const {
+  assert(depth >= 0 && depth < static_cast<int>(depth_map_.size()));
   return depth_map_[depth];
 }
 
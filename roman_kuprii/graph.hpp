@@ -2,10 +2,17 @@
 
 #include <array>
 #include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
+#include "small_vector.hpp"
+
 namespace uni_cpp_practice {
 
 using EdgeId = int;
@@ -13,8 +20,15 @@ using VertexId = int;
 
 constexpr int INVALID_ID = -1;
 
+enum class EdgeColor : uint8_t { Gray, Green, Blue, Yellow, Red };
+
+// most vertices have a gray parent edge and up to three colored edges
+constexpr int VERTEX_INLINE_EDGES_COUNT = 4;
+using VertexEdgeIds = SmallVector<EdgeId, VERTEX_INLINE_EDGES_COUNT>;
+
 struct Edge {
-  enum class Color { Gray, Green, Blue, Yellow, Red };
+  using Color = EdgeColor;
+  static constexpr int COLORS_COUNT = 5;
 
   const EdgeId id = INVALID_ID;
   const std::array<VertexId, 2> connected_vertices;
@@ -35,19 +49,62 @@ struct Vertex {
 
   void add_edge_id(const EdgeId& _id);
 
-  const std::vector<EdgeId>& get_edges_ids() const { return edges_ids_; }
+  const VertexEdgeIds& get_edges_ids() const { return edges_ids_; }
 
   const VertexId& get_id() const { return id_; }
 
  private:
   const VertexId id_ = INVALID_ID;
-  std::vector<EdgeId> edges_ids_;
+  VertexEdgeIds edges_ids_;
 };
 
 class Graph {
  public:
+  // estimated heap bytes held by the graph containers, not counting what the
+  // memory resource has reserved beyond them
+  struct MemoryUsage {
+    // vertex hash map buckets and nodes
+    size_t vertices = 0;
+    // edge ids of vertices that outgrew the inline storage
+    size_t vertex_edge_lists = 0;
+    // edge hash map buckets and nodes
+    size_t edges = 0;
+    size_t adjacency = 0;
+    // per-color edge ids
+    size_t edge_columns = 0;
+    // depth buckets and vertex positions inside them
+    size_t depth_map = 0;
+
+    size_t get_total() const {
+      return vertices + vertex_edge_lists + edges + adjacency + edge_columns +
+             depth_map;
+    }
+  };
+
+  // all containers of the graph allocate from memory_resource, which has to
+  // outlive the graph unless memory_owner keeps it alive
+  explicit Graph(std::pmr::memory_resource* memory_resource =
+                     std::pmr::get_default_resource(),
+                 std::shared_ptr<void> memory_owner = nullptr);
+
+  // graphs are handed over by move only, a move keeps the memory resource
+  Graph(const Graph&) = delete;
+  Graph& operator=(const Graph&) = delete;
+  Graph(Graph&&) = default;
+  Graph& operator=(Graph&&) = delete;
+
   VertexId add_vertex();
 
+  // preallocates storage for a graph of the expected size. Edge lists of
+  // vertices are left alone, most of them fit the inline storage
+  void reserve(int vertices_count,
+               int edges_count,
+               const std::vector<int>& vertices_count_per_depth);
+
+  // removes all vertices and edges but keeps the capacity of every container,
+  // so refilling the graph to a similar size barely allocates
+  void clear();
+
   bool is_vertex_exist(const VertexId& vertex_id) const;
 
   bool is_connected(const VertexId& from_vertex_id,
@@ -56,25 +113,48 @@ class Graph {
   void connect_vertices(const VertexId& from_vertex_id,
                         const VertexId& to_vertex_id);
 
-  const std::unordered_map<EdgeId, Edge>& get_edges() const { return edges_; }
-  const std::unordered_map<VertexId, Vertex>& get_vertices() const {
+  const std::pmr::unordered_map<EdgeId, Edge>& get_edges() const {
+    return edges_;
+  }
+  const std::pmr::unordered_map<VertexId, Vertex>& get_vertices() const {
     return vertices_;
   }
-  const std::vector<VertexId>& get_vertex_ids_at_depth(int depth) const;
+  const std::pmr::vector<VertexId>& get_vertex_ids_at_depth(int depth) const;
+
+  int get_depth() const { return depth_; }
+
+  MemoryUsage memory_usage() const;
 
-  int get_depth() const { return depth_map_.size() - 1; }
+  const std::pmr::vector<EdgeId>& get_edge_ids_with_color(
+      const EdgeColor& color) const {
+    return color_edges_map_[static_cast<int>(color)];
+  }
 
-  std::vector<EdgeId> get_edge_ids_with_color(const Edge::Color& color) const;
+  int get_edges_count_with_color(const EdgeColor& color) const {
+    return get_edge_ids_with_color(color).size();
+  }
 
  private:
-  std::unordered_map<VertexId, Vertex> vertices_;
-  std::unordered_map<EdgeId, Edge> edges_;
-  std::vector<std::vector<VertexId>> depth_map_;
+  // declared first, so the memory is released after all containers
+  std::shared_ptr<void> memory_owner_;
+  std::pmr::unordered_map<VertexId, Vertex> vertices_;
+  std::pmr::unordered_map<EdgeId, Edge> edges_;
+  // packed (min, max) ids of every connected pair of vertices
+  std::pmr::unordered_set<uint64_t> adjacency_;
+  // edge ids of every color, filled in creation order by connect_vertices
+  std::array<std::pmr::vector<EdgeId>, Edge::COLORS_COUNT> color_edges_map_;
+  std::pmr::vector<std::pmr::vector<VertexId>> depth_map_;
+  // depth_map_ may hold reserved buckets deeper than the graph itself
+  int depth_ = -1;
+  // position of every vertex inside its depth_map_ bucket, indexed by id
+  std::pmr::vector<int> depth_map_positions_;
   VertexId vertex_id_counter_ = 0;
   EdgeId edge_id_counter_ = 0;
 
   VertexId get_next_vertex_id() { return vertex_id_counter_++; }
-  VertexId get_next_edge_id() { return edge_id_counter_++; }
+  EdgeId get_next_edge_id() { return edge_id_counter_++; }
+
+  void move_vertex_to_depth(const VertexId& vertex_id, int new_depth);
 };
 
 }  // namespace uni_cpp_practice
@@ -1,14 +1,20 @@
 #include <functional>
 #include <list>
+#include <memory>
 #include <mutex>
 #include <optional>
 #include <random>
 #include <thread>
 #include <vector>
 
+#include "allocation_tracker.hpp"
 #include "graph.hpp"
 #include "graph_generation_controller.hpp"
 #include "graph_generator.hpp"
+#include "graph_pool.hpp"
+#include "metrics_exporter.hpp"
+#include "phase_timers.hpp"
+#include "tracer.hpp"
 
 namespace uni_cpp_practice {
 
@@ -29,6 +35,7 @@ GraphGenerationController::GraphGenerationController(
           }
           const auto job = jobs_.front();
           jobs_.pop_front();
+          metrics::get_metrics().generation.queue_depth--;
           return job;
         });
   }
@@ -38,6 +45,17 @@ void GraphGenerationController::generate(
     const GenStartedCallback& gen_started_callback,
     const GenFinishedCallback& gen_finished_callback) {
   std::atomic<int> completed_jobs = 0;
+  graph_recorders_.clear();
+  for (int i = 0; i < graphs_count_; i++)
+    graph_recorders_.push_back(
+        phase_timers::is_enabled()
+            ? std::make_unique<phase_timers::Recorder>(
+                  &phase_timers::get_run_recorder())
+            : nullptr);
+  graph_allocations_.clear();
+  for (int i = 0; i < graphs_count_; i++)
+    graph_allocations_.push_back(
+        std::make_unique<allocation_tracking::JobAllocations>());
 
   for (auto& worker : workers_) {
     worker.start();
@@ -45,20 +63,36 @@ void GraphGenerationController::generate(
 
   {
     std::lock_guard lock(get_job_mutex_);
+    metrics::get_metrics().generation.queue_depth += graphs_count_;
     for (int i = 0; i < graphs_count_; i++) {
       jobs_.emplace_back([&gen_started_callback = gen_started_callback,
                           &gen_finished_callback = gen_finished_callback, i,
                           &finish_callback_mutex_ = finish_callback_mutex_,
                           &start_callback_mutex_ = start_callback_mutex_,
                           &graph_generator_ = graph_generator_,
-                          &completed_jobs = completed_jobs]() {
+                          &completed_jobs = completed_jobs, this]() {
+        const tracer::ScopedEvent job_event("generation_job", "job", i);
+        const metrics::ScopedActiveWorker active_worker(
+            metrics::get_metrics().generation);
+        const allocation_tracking::ScopedJob job_allocations(
+            graph_allocations_[i].get());
         {
+          const tracer::ScopedEvent event("gen_started_callback", "callback",
+                                          i);
           const std::lock_guard lock(start_callback_mutex_);
           gen_started_callback(i);
         }
 
-        auto graph = graph_generator_.generate();
         {
+          auto graph = graph_pool_->acquire();
+          {
+            const tracer::ScopedEvent event("generate_graph", "phase", i);
+            graph_generator_.generate_into(*graph, graph_recorders_[i].get());
+          }
+          metrics::get_metrics().generation.completed_jobs++;
+          // includes the wait for the lock, callbacks run one at a time
+          const tracer::ScopedEvent event("gen_finished_callback", "callback",
+                                          i);
           const std::lock_guard lock(finish_callback_mutex_);
           gen_finished_callback(std::move(graph), i);
         }
@@ -74,6 +108,23 @@ void GraphGenerationController::generate(
   }
 }
 
+phase_timers::Recorder::Histograms
+GraphGenerationController::get_phase_timings(int graph_index) const {
+  const auto& recorder = graph_recorders_.at(graph_index);
+  return recorder ? recorder->get_histograms()
+                  : phase_timers::Recorder::Histograms();
+}
+
+phase_timers::Recorder* GraphGenerationController::get_phase_recorder(
+    int graph_index) const {
+  return graph_recorders_.at(graph_index).get();
+}
+
+const allocation_tracking::JobAllocations&
+GraphGenerationController::get_allocations(int graph_index) const {
+  return *graph_allocations_.at(graph_index);
+}
+
 GraphGenerationController::Worker::~Worker() {
   if (state_ == State::Working)
     stop();
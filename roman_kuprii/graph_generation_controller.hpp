@@ -3,16 +3,20 @@
 #include <atomic>
 #include <functional>
 #include <list>
+#include <memory>
 #include <mutex>
 #include <optional>
 #include <thread>
+#include <vector>
 
+#include "allocation_tracker.hpp"
 #include "graph_generator.hpp"
+#include "graph_pool.hpp"
+#include "phase_timers.hpp"
+#include "profiled_mutex.hpp"
 
 namespace uni_cpp_practice {
 
-class Graph;
-
 namespace graph_generation_controller {
 
 class GraphGenerationController {
@@ -20,7 +24,9 @@ class GraphGenerationController {
   using JobCallback = std::function<void()>;
   using GetJobCallback = std::function<std::optional<JobCallback>()>;
   using GenStartedCallback = std::function<void(int)>;
-  using GenFinishedCallback = std::function<void(Graph, int)>;
+  // the graph is borrowed from the controller's pool and returns there, with
+  // its capacity kept for the next job, once the callback drops the handle
+  using GenFinishedCallback = std::function<void(GraphPool::Handle, int)>;
 
   class Worker {
    public:
@@ -48,14 +54,33 @@ class GraphGenerationController {
   void generate(const GenStartedCallback& gen_started_callback,
                 const GenFinishedCallback& gen_finished_callback);
 
+  // phase timings of the graph generated by the last generate() call, ready
+  // by the time its finished callback runs; they add up in the run recorder.
+  // Empty while timing is disabled
+  phase_timers::Recorder::Histograms get_phase_timings(int graph_index) const;
+
+  // recorder of the graph's job, for phases timed on its behalf outside of the
+  // controller, such as writing the graph; it reports to the run recorder.
+  // Null while timing is disabled
+  phase_timers::Recorder* get_phase_recorder(int graph_index) const;
+
+  // allocations of the job of the graph, counted while allocation tracking is
+  // enabled; like the timings, complete by the time its finished callback runs
+  const allocation_tracking::JobAllocations& get_allocations(
+      int graph_index) const;
+
  private:
   std::list<Worker> workers_;
   std::list<JobCallback> jobs_;
   int graphs_count_;
   GraphGenerator graph_generator_;
-  std::mutex start_callback_mutex_;
-  std::mutex finish_callback_mutex_;
-  std::mutex get_job_mutex_;
+  ProfiledMutex start_callback_mutex_{"generation.start_callback"};
+  ProfiledMutex finish_callback_mutex_{"generation.finish_callback"};
+  ProfiledMutex get_job_mutex_{"generation.get_job"};
+  std::shared_ptr<GraphPool> graph_pool_ = std::make_shared<GraphPool>();
+  std::vector<std::unique_ptr<phase_timers::Recorder>> graph_recorders_;
+  std::vector<std::unique_ptr<allocation_tracking::JobAllocations>>
+      graph_allocations_;
 };
 
 }  // namespace graph_generation_controller
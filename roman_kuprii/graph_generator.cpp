@@ -1,14 +1,24 @@
+#include <algorithm>
 #include <atomic>
+#include <cassert>
+#include <cmath>
+#include <exception>
 #include <functional>
 #include <list>
+#include <memory>
+#include <memory_resource>
 #include <mutex>
 #include <optional>
 #include <random>
 #include <thread>
 #include <vector>
 
+#include "allocation_tracker.hpp"
 #include "graph.hpp"
 #include "graph_generator.hpp"
+#include "phase_timers.hpp"
+#include "profiled_mutex.hpp"
+#include "tracer.hpp"
 
 namespace {
 
@@ -34,13 +44,32 @@ constexpr int MAX_THREADS_COUNT = 4;
 
 using std::vector;
 
-using uni_cpp_practice::Edge;
 using uni_cpp_practice::Graph;
 using uni_cpp_practice::INVALID_ID;
-using uni_cpp_practice::Vertex;
 using uni_cpp_practice::VertexId;
+using uni_cpp_practice::ProfiledMutex;
+using uni_cpp_practice::allocation_tracking::ScopedContext;
+using uni_cpp_practice::allocation_tracking::ScopedPhase;
+using uni_cpp_practice::phase_timers::Phase;
+using uni_cpp_practice::phase_timers::Recorder;
+using uni_cpp_practice::phase_timers::ScopedTimer;
+using uni_cpp_practice::tracer::ScopedEvent;
 
-void add_blue_edges(Graph& work_graph, std::mutex& add_edge_mutex) {
+// runs the job and keeps the first exception thrown by any of the jobs sharing
+// exception, so it can be rethrown once all threads are joined
+void run_keeping_exception(const std::function<void()>& job,
+                           std::exception_ptr& exception,
+                           std::mutex& exception_mutex) {
+  try {
+    job();
+  } catch (...) {
+    const std::lock_guard lock(exception_mutex);
+    if (!exception)
+      exception = std::current_exception();
+  }
+}
+
+void add_blue_edges(Graph& work_graph, ProfiledMutex& add_edge_mutex) {
   const int graph_depth = work_graph.get_depth();
   for (int current_depth = 1; current_depth <= graph_depth; current_depth++) {
     const auto& vertex_ids_at_current_depth =
@@ -70,7 +99,7 @@ void add_blue_edges(Graph& work_graph, std::mutex& add_edge_mutex) {
   }
 }
 
-void add_green_edges(Graph& work_graph, std::mutex& add_edge_mutex) {
+void add_green_edges(Graph& work_graph, ProfiledMutex& add_edge_mutex) {
   for (const auto& [vertex_id, vertex] : work_graph.get_vertices())
     if (get_real_random_number() < GREEN_TRASHOULD) {
       std::lock_guard lock(add_edge_mutex);
@@ -78,7 +107,7 @@ void add_green_edges(Graph& work_graph, std::mutex& add_edge_mutex) {
     }
 }
 
-void add_red_edges(Graph& work_graph, std::mutex& add_edge_mutex) {
+void add_red_edges(Graph& work_graph, ProfiledMutex& add_edge_mutex) {
   const int graph_depth = work_graph.get_depth();
   for (const auto& [start_vertex_id, start_vertex] :
        work_graph.get_vertices()) {
@@ -97,14 +126,16 @@ void add_red_edges(Graph& work_graph, std::mutex& add_edge_mutex) {
   }
 }
 
-void add_yellow_edges(Graph& work_graph, std::mutex& add_edge_mutex) {
+void add_yellow_edges(Graph& work_graph, ProfiledMutex& add_edge_mutex) {
   const int graph_depth = work_graph.get_depth();
+  // cleared for every vertex, so it allocates only while it grows
+  vector<VertexId> yellow_vertices_ids;
   for (const auto& [start_vertex_id, start_vertex] :
        work_graph.get_vertices()) {
     const double probability = static_cast<double>(start_vertex.depth) /
                                static_cast<double>(graph_depth);
     if (get_real_random_number() < probability) {
-      vector<VertexId> yellow_vertices_ids;
+      yellow_vertices_ids.clear();
       if (start_vertex.depth + 1 <= graph_depth) {
         const auto& vertex_on_next_depth =
             work_graph.get_vertex_ids_at_depth(start_vertex.depth + 1);
@@ -129,24 +160,53 @@ void add_yellow_edges(Graph& work_graph, std::mutex& add_edge_mutex) {
   }
 }
 
-void paint_edges(Graph& work_graph) {
-  std::mutex add_edges_mutex;
-  std::thread blue_thread([&work_graph, &add_edges_mutex]() {
-    add_blue_edges(work_graph, add_edges_mutex);
-  });
-  std::thread green_thread([&work_graph, &add_edges_mutex]() {
-    add_green_edges(work_graph, add_edges_mutex);
-  });
-  std::thread red_thread([&work_graph, &add_edges_mutex]() {
-    add_red_edges(work_graph, add_edges_mutex);
-  });
-  std::thread yellow_thread([&work_graph, &add_edges_mutex]() {
-    add_yellow_edges(work_graph, add_edges_mutex);
-  });
+void paint_edges(Graph& work_graph, Recorder* recorder) {
+  ProfiledMutex add_edges_mutex("generator.add_edge");
+  std::exception_ptr exception;
+  std::mutex exception_mutex;
+  const auto paint_thread = [&exception, &exception_mutex](
+                                const std::function<void()>& add_edges) {
+    return std::thread(
+        [&exception, &exception_mutex, add_edges,
+         context = uni_cpp_practice::allocation_tracking::get_context()]() {
+          const ScopedContext allocation_context(context);
+          run_keeping_exception(add_edges, exception, exception_mutex);
+        });
+  };
+  std::thread blue_thread =
+      paint_thread([&work_graph, &add_edges_mutex, recorder]() {
+        const ScopedTimer timer(recorder, Phase::BlueEdges);
+        const ScopedPhase allocation_phase(Phase::BlueEdges);
+        const ScopedEvent event("blue_edges", "phase");
+        add_blue_edges(work_graph, add_edges_mutex);
+      });
+  std::thread green_thread =
+      paint_thread([&work_graph, &add_edges_mutex, recorder]() {
+        const ScopedTimer timer(recorder, Phase::GreenEdges);
+        const ScopedPhase allocation_phase(Phase::GreenEdges);
+        const ScopedEvent event("green_edges", "phase");
+        add_green_edges(work_graph, add_edges_mutex);
+      });
+  std::thread red_thread =
+      paint_thread([&work_graph, &add_edges_mutex, recorder]() {
+        const ScopedTimer timer(recorder, Phase::RedEdges);
+        const ScopedPhase allocation_phase(Phase::RedEdges);
+        const ScopedEvent event("red_edges", "phase");
+        add_red_edges(work_graph, add_edges_mutex);
+      });
+  std::thread yellow_thread =
+      paint_thread([&work_graph, &add_edges_mutex, recorder]() {
+        const ScopedTimer timer(recorder, Phase::YellowEdges);
+        const ScopedPhase allocation_phase(Phase::YellowEdges);
+        const ScopedEvent event("yellow_edges", "phase");
+        add_yellow_edges(work_graph, add_edges_mutex);
+      });
   blue_thread.join();
   green_thread.join();
   red_thread.join();
   yellow_thread.join();
+  if (exception)
+    std::rethrow_exception(exception);
 }
 
 }  // namespace
@@ -154,12 +214,11 @@ void paint_edges(Graph& work_graph) {
 namespace uni_cpp_practice {
 
 void GraphGenerator::generate_gray_branch(Graph& work_graph,
-                                          std::mutex& graph_mutex,
+                                          ProfiledMutex& graph_mutex,
                                           const VertexId& parent_vertex_id,
                                           int current_depth) const {
   const int depth = params_.depth;
-  const VertexId new_vertex_id = [&work_graph, &graph_mutex,
-                                  &parent_vertex_id]() {
+  const auto new_vertex_id = [&work_graph, &graph_mutex, &parent_vertex_id]() {
     const std::lock_guard lock(graph_mutex);
     const auto new_vertex_id = work_graph.add_vertex();
     work_graph.connect_vertices(parent_vertex_id, new_vertex_id);
@@ -185,17 +244,27 @@ void GraphGenerator::generate_new_vertices(
     const VertexId& parent_vertex_id) const {
   std::list<std::function<void()>> jobs;
   std::atomic<int> completed_jobs = 0;
-  std::mutex graph_mutex;
+  ProfiledMutex graph_mutex("generator.graph");
+  std::exception_ptr exception;
+  std::mutex exception_mutex;
   for (int i = 0; i < params_.new_vertices_num; i++)
-    jobs.emplace_back(
-        [this, &graph, &completed_jobs, &graph_mutex, parent_vertex_id]() {
-          generate_gray_branch(graph, graph_mutex, parent_vertex_id, 1);
-          completed_jobs++;
-        });
+    jobs.emplace_back([this, &graph, &completed_jobs, &graph_mutex,
+                       &exception, &exception_mutex, parent_vertex_id]() {
+      run_keeping_exception(
+          [this, &graph, &graph_mutex, parent_vertex_id]() {
+            const ScopedEvent event("gray_branch", "job");
+            generate_gray_branch(graph, graph_mutex, parent_vertex_id, 1);
+          },
+          exception, exception_mutex);
+      completed_jobs++;
+    });
 
   std::atomic<bool> should_terminate = false;
   std::mutex jobs_mutex;
-  auto worker = [&should_terminate, &jobs_mutex, &jobs]() {
+  // gray branches are allocated on behalf of the job that started the workers
+  auto worker = [&should_terminate, &jobs_mutex, &jobs,
+                 context = allocation_tracking::get_context()]() {
+    const ScopedContext allocation_context(context);
     while (true) {
       if (should_terminate) {
         return;
@@ -233,13 +302,82 @@ void GraphGenerator::generate_new_vertices(
   for (auto& thread : threads) {
     thread.join();
   }
+  if (exception)
+    std::rethrow_exception(exception);
+}
+
+GraphGenerator::GraphSize GraphGenerator::estimate_graph_size() const {
+  const int depth = params_.depth;
+  const int new_vertices_num = params_.new_vertices_num;
+
+  // root always gets new_vertices_num children, a vertex at depth d < depth
+  // gets each of its new_vertices_num children with probability 1 - d / depth
+  vector<double> expected_per_depth = {1.0,
+                                       static_cast<double>(new_vertices_num)};
+  for (int current_depth = 1; current_depth < depth; current_depth++) {
+    const double probability =
+        1.0 - static_cast<double>(current_depth) / static_cast<double>(depth);
+    expected_per_depth.push_back(expected_per_depth.back() * new_vertices_num *
+                                 probability);
+  }
+
+  const int graph_depth = expected_per_depth.size() - 1;
+  double expected_vertices = 0;
+  double expected_blue_edges = 0;
+  double expected_yellow_edges = 0;
+  double expected_red_edges = 0;
+  for (int current_depth = 0; current_depth <= graph_depth; current_depth++) {
+    const double vertices_at_depth = expected_per_depth[current_depth];
+    expected_vertices += vertices_at_depth;
+    if (current_depth > 0)
+      expected_blue_edges +=
+          BLUE_TRASHOULD * std::max(vertices_at_depth - 1.0, 0.0);
+    if (current_depth + 1 <= graph_depth)
+      expected_yellow_edges += vertices_at_depth *
+                               static_cast<double>(current_depth) /
+                               static_cast<double>(graph_depth);
+    if (current_depth + 2 <= graph_depth)
+      expected_red_edges += RED_TRASHOULD * vertices_at_depth;
+  }
+  const double expected_gray_edges = expected_vertices - 1.0;
+  const double expected_green_edges = GREEN_TRASHOULD * expected_vertices;
+
+  GraphSize graph_size;
+  graph_size.vertices_count = std::ceil(expected_vertices);
+  graph_size.edges_count =
+      std::ceil(expected_gray_edges + expected_green_edges +
+                expected_blue_edges + expected_yellow_edges +
+                expected_red_edges);
+  for (const auto& vertices_at_depth : expected_per_depth)
+    graph_size.vertices_count_per_depth.push_back(std::ceil(vertices_at_depth));
+  return graph_size;
 }
 
-Graph GraphGenerator::generate() const {
-  auto graph = Graph();
+void GraphGenerator::fill_graph(Graph& graph,
+                                phase_timers::Recorder* recorder) const {
+  const auto graph_size = estimate_graph_size();
+  graph.reserve(graph_size.vertices_count, graph_size.edges_count,
+                graph_size.vertices_count_per_depth);
   const auto parent_vertex_id = graph.add_vertex();
-  generate_new_vertices(graph, parent_vertex_id);
-  paint_edges(graph);
+  {
+    const ScopedTimer timer(recorder, Phase::NewVertices);
+    const ScopedPhase allocation_phase(Phase::NewVertices);
+    const ScopedEvent event("new_vertices", "phase");
+    generate_new_vertices(graph, parent_vertex_id);
+  }
+  paint_edges(graph, recorder);
+}
+
+void GraphGenerator::generate_into(Graph& graph,
+                                   phase_timers::Recorder* recorder) const {
+  assert(graph.get_vertices().empty());
+  fill_graph(graph, recorder);
+}
+
+Graph GraphGenerator::generate(std::pmr::memory_resource* memory_resource,
+                               std::shared_ptr<void> memory_owner) const {
+  auto graph = Graph(memory_resource, std::move(memory_owner));
+  fill_graph(graph, nullptr);
   return graph;
 }
 
@@ -1,10 +1,15 @@
 #pragma once
 
+#include <memory>
+#include <memory_resource>
 #include <mutex>
+#include <vector>
 
-namespace uni_cpp_practice {
+#include "graph.hpp"
+#include "phase_timers.hpp"
+#include "profiled_mutex.hpp"
 
-class Graph;
+namespace uni_cpp_practice {
 
 class GraphGenerator {
  public:
@@ -16,15 +21,33 @@ class GraphGenerator {
     int new_vertices_num = 0;
   };
 
-  Graph generate() const;
+  // expected (rounded up) size of a generated graph, used for preallocation
+  struct GraphSize {
+    int vertices_count = 0;
+    int edges_count = 0;
+    std::vector<int> vertices_count_per_depth;
+  };
+
+  // memory_owner is stored in the graph and keeps memory_resource alive
+  Graph generate(std::pmr::memory_resource* memory_resource =
+                     std::pmr::get_default_resource(),
+                 std::shared_ptr<void> memory_owner = nullptr) const;
+
+  // generates into an empty or cleared graph, reusing its capacity; the
+  // vertices and every paint pass are timed into recorder when it is given
+  void generate_into(Graph& graph,
+                     phase_timers::Recorder* recorder = nullptr) const;
+
+  GraphSize estimate_graph_size() const;
 
   GraphGenerator(const Params& params) : params_(params) {}
 
  private:
   Params params_;
 
+  void fill_graph(Graph& graph, phase_timers::Recorder* recorder) const;
   void generate_gray_branch(Graph& graph,
-                            std::mutex& graph_mutex,
+                            ProfiledMutex& graph_mutex,
                             const VertexId& parent_vertex_id,
                             int current_depth) const;
   void generate_new_vertices(Graph& graph,
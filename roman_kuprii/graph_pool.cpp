@@ -0,0 +1,42 @@
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <vector>
+
+#include "graph.hpp"
+#include "graph_pool.hpp"
+
+namespace uni_cpp_practice {
+
+GraphPool::Handle GraphPool::acquire() {
+  std::unique_ptr<Graph> graph;
+  {
+    const std::lock_guard lock(mutex_);
+    if (!free_graphs_.empty()) {
+      graph = std::move(free_graphs_.back());
+      free_graphs_.pop_back();
+    }
+  }
+  if (!graph) {
+    // a graph is used by one thread at a time, handed over under a lock
+    auto memory_resource =
+        std::make_shared<std::pmr::unsynchronized_pool_resource>();
+    graph = std::make_unique<Graph>(memory_resource.get(), memory_resource);
+  }
+  return Handle(graph.release(), Recycler(shared_from_this()));
+}
+
+void GraphPool::release(Graph* graph) {
+  graph->clear();
+  const std::lock_guard lock(mutex_);
+  free_graphs_.emplace_back(graph);
+}
+
+void GraphPool::Recycler::operator()(Graph* graph) const {
+  if (pool_)
+    pool_->release(graph);
+  else
+    delete graph;
+}
+
+}  // namespace uni_cpp_practice
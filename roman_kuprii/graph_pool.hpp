@@ -0,0 +1,41 @@
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "graph.hpp"
+
+namespace uni_cpp_practice {
+
+// keeps cleared graphs with all their capacity for the next generation job.
+// Every pooled graph allocates from its own pool resource, so the hash map
+// nodes freed by clear() are handed out again when the graph is refilled
+class GraphPool : public std::enable_shared_from_this<GraphPool> {
+ public:
+  // clears the graph and returns it to the pool, which it keeps alive
+  class Recycler {
+   public:
+    Recycler() = default;
+    explicit Recycler(std::shared_ptr<GraphPool> pool)
+        : pool_(std::move(pool)) {}
+
+    void operator()(Graph* graph) const;
+
+   private:
+    std::shared_ptr<GraphPool> pool_;
+  };
+
+  using Handle = std::unique_ptr<Graph, Recycler>;
+
+  // the graph is empty; it goes back to the pool when the handle is dropped
+  Handle acquire();
+
+ private:
+  std::vector<std::unique_ptr<Graph>> free_graphs_;
+  std::mutex mutex_;
+
+  void release(Graph* graph);
+};
+
+}  // namespace uni_cpp_practice
@@ -7,9 +7,12 @@
 #include <string>
 #include <vector>
 
+#include "allocation_tracker.hpp"
 #include "graph.hpp"
 #include "graph_printing.hpp"
 #include "graph_traverser.hpp"
+#include "phase_timers.hpp"
+#include "tracer.hpp"
 
 namespace {
 
@@ -67,7 +70,13 @@ std::string vertex_to_json(const Vertex& vertex) {
   return res;
 }
 
-std::string graph_to_json(const Graph& graph) {
+std::string graph_to_json(const Graph& graph,
+                          phase_timers::Recorder* recorder) {
+  const phase_timers::ScopedTimer timer(recorder,
+                                        phase_timers::Phase::GraphToJson);
+  const tracer::ScopedEvent event("graph_to_json", "phase");
+  const allocation_tracking::ScopedPhase allocation_phase(
+      phase_timers::Phase::GraphToJson);
   std::string res;
   res = "{ \"depth\": ";
   res += to_string(graph.get_depth());
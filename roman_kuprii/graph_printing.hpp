@@ -3,16 +3,16 @@
 #include <string>
 
 #include "graph_traverser.hpp"
+#include "phase_timers.hpp"
 
 namespace uni_cpp_practice {
 
-class Graph;
-
 namespace graph_printing {
 
 std::string color_to_string(const Edge::Color& color);
 
-std::string graph_to_json(const Graph& graph);
+std::string graph_to_json(const Graph& graph,
+                          phase_timers::Recorder* recorder = nullptr);
 std::string vertex_to_json(const Vertex& graph);
 std::string edge_to_json(const Graph& graph);
 
@@ -0,0 +1,76 @@
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "graph.hpp"
+#include "graph_snapshot.hpp"
+
+namespace uni_cpp_practice {
+
+GraphSnapshot GraphSnapshot::freeze(const Graph& graph) {
+  auto data = std::make_shared<Data>();
+  const int vertices_count = graph.get_vertices().size();
+  const int depth = graph.get_depth();
+
+  // every vertex lists its edges, so the edge ids column holds the sum of
+  // the degrees
+  size_t vertex_edge_ids_count = 0;
+  for (const auto& [vertex_id, vertex] : graph.get_vertices())
+    vertex_edge_ids_count += vertex.get_edges_ids().size();
+
+  data->vertex_depths.resize(vertices_count);
+  data->vertex_edge_ids.reserve(vertex_edge_ids_count);
+  data->vertex_edges_offsets.reserve(vertices_count + 1);
+  data->vertex_edges_offsets.push_back(0);
+  for (VertexId vertex_id = 0; vertex_id < vertices_count; vertex_id++) {
+    const auto& vertex = graph.get_vertices().at(vertex_id);
+    data->vertex_depths[vertex_id] = vertex.depth;
+    const auto& edge_ids = vertex.get_edges_ids();
+    data->vertex_edge_ids.insert(data->vertex_edge_ids.end(), edge_ids.begin(),
+                                 edge_ids.end());
+    data->vertex_edges_offsets.push_back(data->vertex_edge_ids.size());
+  }
+
+  data->depth_offsets.reserve(depth + 2);
+  data->depth_offsets.push_back(0);
+  data->vertex_ids_by_depth.reserve(vertices_count);
+  for (int current_depth = 0; current_depth <= depth; current_depth++) {
+    const auto& vertex_ids = graph.get_vertex_ids_at_depth(current_depth);
+    data->vertex_ids_by_depth.insert(data->vertex_ids_by_depth.end(),
+                                     vertex_ids.begin(), vertex_ids.end());
+    data->depth_offsets.push_back(data->vertex_ids_by_depth.size());
+  }
+
+  // the edge columns are indexed by id, so the edges fill them in any order
+  const int edges_count = graph.get_edges().size();
+  data->edge_from_vertex_ids.resize(edges_count);
+  data->edge_to_vertex_ids.resize(edges_count);
+  data->edge_colors.resize(edges_count);
+  for (const auto& [edge_id, edge] : graph.get_edges()) {
+    data->edge_from_vertex_ids[edge_id] = edge.connected_vertices[0];
+    data->edge_to_vertex_ids[edge_id] = edge.connected_vertices[1];
+    data->edge_colors[edge_id] = static_cast<uint8_t>(edge.color);
+  }
+  for (int color = 0; color < Edge::COLORS_COUNT; color++)
+    data->color_edges_counts[color] =
+        graph.get_edges_count_with_color(static_cast<EdgeColor>(color));
+
+  return GraphSnapshot(std::move(data));
+}
+
+size_t GraphSnapshot::memory_usage() const {
+  const auto vector_memory_usage = [](const auto& vector) {
+    return vector.capacity() * sizeof(vector[0]);
+  };
+  return sizeof(Data) + vector_memory_usage(data_->vertex_depths) +
+         vector_memory_usage(data_->vertex_edges_offsets) +
+         vector_memory_usage(data_->vertex_edge_ids) +
+         vector_memory_usage(data_->depth_offsets) +
+         vector_memory_usage(data_->vertex_ids_by_depth) +
+         vector_memory_usage(data_->edge_from_vertex_ids) +
+         vector_memory_usage(data_->edge_to_vertex_ids) +
+         vector_memory_usage(data_->edge_colors);
+}
+
+}  // namespace uni_cpp_practice
@@ -0,0 +1,114 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "graph.hpp"
+#include "huge_pages.hpp"
+
+namespace uni_cpp_practice {
+
+// read-only view over a contiguous run of ids
+template <typename IdType>
+class IdsView {
+ public:
+  IdsView(const IdType* begin, const IdType* end) : begin_(begin), end_(end) {}
+
+  const IdType* begin() const { return begin_; }
+  const IdType* end() const { return end_; }
+  int size() const { return end_ - begin_; }
+  bool empty() const { return begin_ == end_; }
+  const IdType& operator[](int index) const { return begin_[index]; }
+
+ private:
+  const IdType* begin_ = nullptr;
+  const IdType* end_ = nullptr;
+};
+
+// immutable copy of a finished graph, packed into flat arrays indexed by id.
+// Copies share the same frozen data, which is never written after freeze(),
+// so any number of threads may read it without locks; the data is released
+// together with the last copy
+class GraphSnapshot {
+ public:
+  static GraphSnapshot freeze(const Graph& graph);
+
+  int get_vertices_count() const { return data_->vertex_depths.size(); }
+  int get_edges_count() const { return data_->edge_colors.size(); }
+  int get_depth() const { return data_->depth_offsets.size() - 2; }
+
+  bool is_vertex_exist(const VertexId& vertex_id) const {
+    return vertex_id >= 0 && vertex_id < get_vertices_count();
+  }
+
+  int get_vertex_depth(const VertexId& vertex_id) const {
+    return data_->vertex_depths[vertex_id];
+  }
+
+  IdsView<EdgeId> get_vertex_edge_ids(const VertexId& vertex_id) const {
+    return view(data_->vertex_edge_ids, data_->vertex_edges_offsets, vertex_id);
+  }
+
+  IdsView<VertexId> get_vertex_ids_at_depth(int depth) const {
+    return view(data_->vertex_ids_by_depth, data_->depth_offsets, depth);
+  }
+
+  VertexId get_edge_from_vertex_id(const EdgeId& edge_id) const {
+    return data_->edge_from_vertex_ids[edge_id];
+  }
+  VertexId get_edge_to_vertex_id(const EdgeId& edge_id) const {
+    return data_->edge_to_vertex_ids[edge_id];
+  }
+  EdgeColor get_edge_color(const EdgeId& edge_id) const {
+    return static_cast<EdgeColor>(data_->edge_colors[edge_id]);
+  }
+
+  int get_edges_count_with_color(const EdgeColor& color) const {
+    return data_->color_edges_counts[static_cast<int>(color)];
+  }
+
+  // heap bytes of the frozen data shared by all copies of the snapshot
+  size_t memory_usage() const;
+
+  // structure-of-arrays columns, indexed by edge id
+  const HugePageVector<VertexId>& get_edge_to_vertex_ids() const {
+    return data_->edge_to_vertex_ids;
+  }
+  const HugePageVector<uint8_t>& get_edge_colors() const {
+    return data_->edge_colors;
+  }
+
+ private:
+  // the arrays sized by vertices or edges may be backed by huge pages
+  struct Data {
+    HugePageVector<int> vertex_depths;
+    // edges of vertex v are vertex_edge_ids[offsets[v], offsets[v + 1])
+    HugePageVector<int> vertex_edges_offsets;
+    HugePageVector<EdgeId> vertex_edge_ids;
+    // vertices at depth d are vertex_ids_by_depth[offsets[d], offsets[d + 1])
+    std::vector<int> depth_offsets;
+    HugePageVector<VertexId> vertex_ids_by_depth;
+    HugePageVector<VertexId> edge_from_vertex_ids;
+    HugePageVector<VertexId> edge_to_vertex_ids;
+    HugePageVector<uint8_t> edge_colors;
+    std::array<int, Edge::COLORS_COUNT> color_edges_counts = {};
+  };
+
+  std::shared_ptr<const Data> data_;
+
+  explicit GraphSnapshot(std::shared_ptr<const Data> data)
+      : data_(std::move(data)) {}
+
+  template <typename IdType, typename Offsets>
+  static IdsView<IdType> view(const HugePageVector<IdType>& ids,
+                              const Offsets& offsets,
+                              int index) {
+    return IdsView<IdType>(ids.data() + offsets[index],
+                           ids.data() + offsets[index + 1]);
+  }
+};
+
+}  // namespace uni_cpp_practice
@@ -1,14 +1,20 @@
 #include <functional>
 #include <list>
+#include <memory>
 #include <mutex>
 #include <optional>
 #include <random>
 #include <thread>
 #include <vector>
 
+#include "allocation_tracker.hpp"
 #include "graph.hpp"
+#include "graph_snapshot.hpp"
 #include "graph_traversal_controller.hpp"
 #include "graph_traverser.hpp"
+#include "metrics_exporter.hpp"
+#include "phase_timers.hpp"
+#include "tracer.hpp"
 
 namespace uni_cpp_practice {
 
@@ -16,9 +22,9 @@ namespace graph_traversal_controller {
 
 GraphTraversalController::GraphTraversalController(
     int threads_count,
-    const std::vector<Graph>& graphs)
-    : graphs_(graphs) {
-  threads_count = std::min(threads_count, static_cast<int>(graphs.size()));
+    std::vector<GraphSnapshot> graphs)
+    : graphs_(std::move(graphs)) {
+  threads_count = std::min(threads_count, static_cast<int>(graphs_.size()));
   for (int iter = 0; iter < threads_count; iter++) {
     workers_.emplace_back(
         [&jobs_ = jobs_,
@@ -29,6 +35,7 @@ GraphTraversalController::GraphTraversalController(
           }
           const auto job = jobs_.front();
           jobs_.pop_front();
+          metrics::get_metrics().traversal.queue_depth--;
           return job;
         });
   }
@@ -38,6 +45,18 @@ void GraphTraversalController::traverse_graphs(
     const GenStartedCallback& gen_started_callback,
     const GenFinishedCallback& gen_finished_callback) {
   std::atomic<int> completed_jobs = 0;
+  const int graphs_count = graphs_.size();
+  graph_recorders_.clear();
+  for (int i = 0; i < graphs_count; i++)
+    graph_recorders_.push_back(
+        phase_timers::is_enabled()
+            ? std::make_unique<phase_timers::Recorder>(
+                  &phase_timers::get_run_recorder())
+            : nullptr);
+  graph_allocations_.clear();
+  for (int i = 0; i < graphs_count; i++)
+    graph_allocations_.push_back(
+        std::make_unique<allocation_tracking::JobAllocations>());
 
   for (auto& worker : workers_) {
     worker.start();
@@ -45,30 +64,47 @@ void GraphTraversalController::traverse_graphs(
 
   {
     std::lock_guard lock(get_job_mutex_);
-    for (int i = 0; i < graphs_.size(); i++) {
+    metrics::get_metrics().traversal.queue_depth += graphs_count;
+    for (int i = 0; i < graphs_count; i++) {
       jobs_.emplace_back([&gen_started_callback = gen_started_callback,
                           &gen_finished_callback = gen_finished_callback, i,
                           &finish_callback_mutex_ = finish_callback_mutex_,
                           &start_callback_mutex_ = start_callback_mutex_,
                           &completed_jobs = completed_jobs,
-                          &graphs_ = graphs_]() {
+                          recorder = graph_recorders_[i].get(),
+                          allocations = graph_allocations_[i].get(),
+                          graph = std::move(graphs_[i])]() {
+        const tracer::ScopedEvent job_event("traversal_job", "job", i);
+        const metrics::ScopedActiveWorker active_worker(
+            metrics::get_metrics().traversal);
+        const allocation_tracking::ScopedJob job_allocations(allocations);
         {
+          const tracer::ScopedEvent event("gen_started_callback", "callback",
+                                          i);
           const std::lock_guard lock(start_callback_mutex_);
           gen_started_callback(i);
         }
 
-        GraphTraverser graph_traverser(graphs_[i]);
-        const auto paths = graph_traverser.traverse_graph();
+        GraphTraverser graph_traverser(graph, recorder);
+        const auto paths = [&graph_traverser, i]() {
+          const tracer::ScopedEvent event("traverse_graph", "phase", i);
+          return graph_traverser.traverse_graph();
+        }();
+        metrics::get_metrics().traversal.completed_jobs++;
 
         {
+          // includes the wait for the lock, callbacks run one at a time
+          const tracer::ScopedEvent event("gen_finished_callback", "callback",
+                                          i);
           const std::lock_guard lock(finish_callback_mutex_);
-          gen_finished_callback(i, std::move(paths));
+          gen_finished_callback(i, paths, graph_traverser.memory_usage());
         }
         completed_jobs++;
       });
     }
   }
-  while (completed_jobs != graphs_.size()) {
+  graphs_.clear();
+  while (completed_jobs != graphs_count) {
   }
 
   for (auto& worker : workers_) {
@@ -76,6 +112,18 @@ void GraphTraversalController::traverse_graphs(
   }
 }
 
+phase_timers::Recorder::Histograms
+GraphTraversalController::get_phase_timings(int graph_index) const {
+  const auto& recorder = graph_recorders_.at(graph_index);
+  return recorder ? recorder->get_histograms()
+                  : phase_timers::Recorder::Histograms();
+}
+
+const allocation_tracking::JobAllocations&
+GraphTraversalController::get_allocations(int graph_index) const {
+  return *graph_allocations_.at(graph_index);
+}
+
 GraphTraversalController::Worker::~Worker() {
   if (state_ == State::Working)
     stop();
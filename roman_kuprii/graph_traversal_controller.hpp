@@ -1,18 +1,23 @@
 #pragma once
 
 #include <atomic>
+#include <cstddef>
 #include <functional>
 #include <list>
+#include <memory>
 #include <mutex>
 #include <optional>
 #include <thread>
+#include <vector>
 
+#include "allocation_tracker.hpp"
+#include "graph_snapshot.hpp"
 #include "graph_traverser.hpp"
+#include "phase_timers.hpp"
+#include "profiled_mutex.hpp"
 
 namespace uni_cpp_practice {
 
-class Graph;
-
 namespace graph_traversal_controller {
 
 class GraphTraversalController {
@@ -20,8 +25,9 @@ class GraphTraversalController {
   using JobCallback = std::function<void()>;
   using GetJobCallback = std::function<std::optional<JobCallback>()>;
   using GenStartedCallback = std::function<void(int)>;
-  using GenFinishedCallback =
-      std::function<void(int, const std::vector<GraphTraverser::Path>&)>;
+  // gets the paths and the peak scratch bytes of the traversal
+  using GenFinishedCallback = std::function<
+      void(int, const std::vector<GraphTraverser::Path>&, size_t)>;
 
   class Worker {
    public:
@@ -41,18 +47,34 @@ class GraphTraversalController {
     std::atomic<State> state_ = State::Idle;
   };
 
-  GraphTraversalController(int threads_count, const std::vector<Graph>& graphs);
+  // every job holds its own snapshot handle, so a graph is released as soon
+  // as its traversal and all other consumers are done with it
+  GraphTraversalController(int threads_count,
+                           std::vector<GraphSnapshot> graphs);
 
   void traverse_graphs(const GenStartedCallback& gen_started_callback,
                        const GenFinishedCallback& gen_finished_callback);
 
+  // shortest path timings of the graph, ready by the time its finished
+  // callback runs; they add up in the run recorder. Empty while timing is
+  // disabled
+  phase_timers::Recorder::Histograms get_phase_timings(int graph_index) const;
+
+  // allocations of the traversal job of the graph, counted while allocation
+  // tracking is enabled
+  const allocation_tracking::JobAllocations& get_allocations(
+      int graph_index) const;
+
  private:
   std::list<Worker> workers_;
   std::list<JobCallback> jobs_;
-  const std::vector<Graph>& graphs_;
-  std::mutex start_callback_mutex_;
-  std::mutex finish_callback_mutex_;
-  std::mutex get_job_mutex_;
+  std::vector<GraphSnapshot> graphs_;
+  std::vector<std::unique_ptr<phase_timers::Recorder>> graph_recorders_;
+  std::vector<std::unique_ptr<allocation_tracking::JobAllocations>>
+      graph_allocations_;
+  ProfiledMutex start_callback_mutex_{"traversal.start_callback"};
+  ProfiledMutex finish_callback_mutex_{"traversal.finish_callback"};
+  ProfiledMutex get_job_mutex_{"traversal.get_job"};
 };
 
 }  // namespace graph_traversal_controller
@@ -1,5 +1,7 @@
+#include <algorithm>
 #include <atomic>
 #include <cassert>
+#include <cstddef>
 #include <functional>
 #include <list>
 #include <mutex>
@@ -8,8 +10,13 @@
 #include <thread>
 #include <vector>
 
+#include "allocation_tracker.hpp"
 #include "graph.hpp"
+#include "graph_snapshot.hpp"
 #include "graph_traverser.hpp"
+#include "huge_pages.hpp"
+#include "phase_timers.hpp"
+#include "tracer.hpp"
 
 namespace uni_cpp_practice {
 
@@ -22,44 +29,78 @@ const unsigned long MAX_WORKERS_COUNT = std::thread::hardware_concurrency();
 }  // namespace
 
 GraphTraverser::Path GraphTraverser::find_shortest_path(
-    const Graph& graph,
+    const GraphSnapshot& graph,
     const VertexId& source_vertex_id,
-    const VertexId& destination_vertex_id) const {
+    const VertexId& destination_vertex_id,
+    QueryBuffers& buffers) const {
   assert(graph.is_vertex_exist(source_vertex_id));
   assert(graph.is_vertex_exist(destination_vertex_id));
+  const phase_timers::ScopedTimer timer(recorder_,
+                                        phase_timers::Phase::ShortestPath);
+  const allocation_tracking::ScopedPhase allocation_phase(
+      phase_timers::Phase::ShortestPath);
 
-  int vertices_number = graph.get_vertices().size();
-  const auto& source_vertex = graph.get_vertices().at(source_vertex_id);
+  int vertices_number = graph.get_vertices_count();
+  const auto& edge_to_vertex_ids = graph.get_edge_to_vertex_ids();
   // unvisited vertices
-  std::vector<VertexId> vertices(vertices_number, UNVISITED);
+  auto& vertices = buffers.vertices;
+  vertices.assign(vertices_number, UNVISITED);
   vertices[source_vertex_id] = VISITED;
   // create distances
-  std::vector<Distance> distance(vertices_number, MAX_DISTANCE);
+  auto& distance = buffers.distance;
+  distance.assign(vertices_number, MAX_DISTANCE);
   distance[source_vertex_id] = 0;
   // create queue
-  std::queue<Vertex> vertices_queue;
-  vertices_queue.push(source_vertex);
-  // create path
-  std::vector<std::vector<VertexId>> all_pathes(vertices_number);
-  std::vector<VertexId> source_vector(1, source_vertex_id);
-  all_pathes[source_vertex_id] = source_vector;
+  std::queue<VertexId> vertices_queue;
+  vertices_queue.push(source_vertex_id);
+  size_t max_queue_size = 1;
+  // create path, the paths keep their capacity from the earlier queries
+  auto& all_pathes = buffers.pathes;
+  all_pathes.resize(vertices_number);
+  // bytes of the paths themselves, kept up to date as they grow so the
+  // accounting stays O(1) per path update
+  size_t pathes_memory_usage = 0;
+  for (VertexId vertex_id = 0; vertex_id < vertices_number; vertex_id++) {
+    auto& path = all_pathes[vertex_id];
+    path.clear();
+    if (vertex_id == source_vertex_id)
+      path.push_back(source_vertex_id);
+    pathes_memory_usage += path.capacity() * sizeof(VertexId);
+  }
+
+  const auto record_memory_usage = [this, &vertices, &distance, &all_pathes,
+                                    &max_queue_size, &pathes_memory_usage]() {
+    const size_t memory_usage =
+        vertices.capacity() * sizeof(VertexId) +
+        distance.capacity() * sizeof(Distance) +
+        all_pathes.capacity() * sizeof(std::vector<VertexId>) +
+        max_queue_size * sizeof(VertexId) + pathes_memory_usage;
+    size_t max_memory_usage = max_query_memory_usage_;
+    while (max_memory_usage < memory_usage &&
+           !max_query_memory_usage_.compare_exchange_weak(max_memory_usage,
+                                                          memory_usage)) {
+    }
+  };
 
   while (!vertices_queue.empty()) {
-    const auto current_vertex = vertices_queue.front();
+    const auto current_vertex_id = vertices_queue.front();
     vertices_queue.pop();
 
     // check all outcoming edges
-    for (const auto& edge_id : current_vertex.get_edges_ids()) {
-      const auto& edge = graph.get_edges().at(edge_id);
-      VertexId next_vertex_id = edge.connected_vertices.back();
-      const auto& next_vertex = graph.get_vertices().at(next_vertex_id);
+    for (const auto& edge_id : graph.get_vertex_edge_ids(current_vertex_id)) {
+      VertexId next_vertex_id = edge_to_vertex_ids[edge_id];
       // update distances
-      if (distance[current_vertex.get_id()] + 1 < distance[next_vertex_id]) {
-        vertices_queue.push(next_vertex);
-        distance[next_vertex_id] = distance[current_vertex.get_id()] + 1;
-        all_pathes[next_vertex_id] = all_pathes[current_vertex.get_id()];
-        all_pathes[next_vertex_id].push_back(next_vertex_id);
+      if (distance[current_vertex_id] + 1 < distance[next_vertex_id]) {
+        vertices_queue.push(next_vertex_id);
+        max_queue_size = std::max(max_queue_size, vertices_queue.size());
+        distance[next_vertex_id] = distance[current_vertex_id] + 1;
+        auto& next_path = all_pathes[next_vertex_id];
+        pathes_memory_usage -= next_path.capacity() * sizeof(VertexId);
+        next_path = all_pathes[current_vertex_id];
+        next_path.push_back(next_vertex_id);
+        pathes_memory_usage += next_path.capacity() * sizeof(VertexId);
         if (destination_vertex_id == next_vertex_id) {
+          record_memory_usage();
           Path r_path(all_pathes[next_vertex_id], distance[next_vertex_id]);
           return r_path;
         }
@@ -67,21 +108,23 @@ GraphTraverser::Path GraphTraverser::find_shortest_path(
     }
   }
 
+  record_memory_usage();
   throw std::logic_error("Vertices dont connected");
 }
 
 std::vector<GraphTraverser::Path> GraphTraverser::traverse_graph() {
-  std::list<std::function<void()>> jobs;
+  std::list<std::function<void(QueryBuffers&)>> jobs;
   std::atomic<int> completed_jobs = 0;
   std::mutex path_mutex;
-  const auto& vertex_ids = graph_.get_vertex_ids_at_depth(graph_.get_depth());
+  const auto vertex_ids = graph_.get_vertex_ids_at_depth(graph_.get_depth());
   std::vector<GraphTraverser::Path> pathes;
   pathes.reserve(vertex_ids.size());
 
   for (const auto& vertex_id : vertex_ids)
     jobs.emplace_back([this, &graph_ = graph_, &completed_jobs, &vertex_id,
-                       &pathes, &path_mutex]() {
-      auto path = find_shortest_path(graph_, 0, vertex_id);
+                       &pathes, &path_mutex](QueryBuffers& buffers) {
+      const tracer::ScopedEvent event("find_shortest_path", "job");
+      auto path = find_shortest_path(graph_, 0, vertex_id, buffers);
       {
         std::lock_guard lock(path_mutex);
         pathes.emplace_back(path);
@@ -91,13 +134,16 @@ std::vector<GraphTraverser::Path> GraphTraverser::traverse_graph() {
 
   std::atomic<bool> should_terminate = false;
   std::mutex jobs_mutex;
-  auto worker = [&should_terminate, &jobs_mutex, &jobs]() {
+  auto worker = [&should_terminate, &jobs_mutex, &jobs,
+                 context = allocation_tracking::get_context()]() {
+    const allocation_tracking::ScopedContext allocation_context(context);
+    QueryBuffers buffers;
     while (true) {
       if (should_terminate) {
         return;
       }
-      const auto job_optional =
-          [&jobs_mutex, &jobs]() -> std::optional<std::function<void()>> {
+      const auto job_optional = [&jobs_mutex, &jobs]()
+          -> std::optional<std::function<void(QueryBuffers&)>> {
         const std::lock_guard lock(jobs_mutex);
         if (jobs.empty()) {
           return std::nullopt;
@@ -108,16 +154,18 @@ std::vector<GraphTraverser::Path> GraphTraverser::traverse_graph() {
       }();
       if (job_optional.has_value()) {
         const auto& job = job_optional.value();
-        job();
+        job(buffers);
       }
     }
   };
 
-  const auto threads_number = std::min(vertex_ids.size(), MAX_WORKERS_COUNT);
+  const auto threads_number =
+      std::min<unsigned long>(vertex_ids.size(), MAX_WORKERS_COUNT);
   auto threads = std::vector<std::thread>();
   threads.reserve(threads_number);
 
-  for (int i = 0; i < threads_number; ++i) {
+  workers_count_ = threads_number;
+  for (int i = 0; i < static_cast<int>(threads_number); ++i) {
     threads.emplace_back(worker);
   }
 
@@ -132,4 +180,8 @@ std::vector<GraphTraverser::Path> GraphTraverser::traverse_graph() {
   return pathes;
 }
 
+size_t GraphTraverser::memory_usage() const {
+  return max_query_memory_usage_ * std::max<size_t>(workers_count_, 1);
+}
+
 }  // namespace uni_cpp_practice
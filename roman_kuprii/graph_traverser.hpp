@@ -1,15 +1,18 @@
 #pragma once
 
+#include <atomic>
+#include <cstddef>
 #include <mutex>
 #include <optional>
 #include <vector>
 
 #include "graph.hpp"
+#include "graph_snapshot.hpp"
+#include "huge_pages.hpp"
+#include "phase_timers.hpp"
 
 namespace uni_cpp_practice {
 
-class Graph;
-
 class GraphTraverser {
  public:
   using Distance = int;
@@ -21,16 +24,37 @@ class GraphTraverser {
     Distance distance = 0;
   };
 
+  // scratch arrays of a query, reused by all queries of a worker, so the
+  // large ones are mapped once instead of on every query
+  struct QueryBuffers {
+    HugePageVector<VertexId> vertices;
+    HugePageVector<Distance> distance;
+    HugePageVector<std::vector<VertexId>> pathes;
+  };
+
   std::vector<Path> traverse_graph();
 
-  Path find_shortest_path(const Graph& graph,
+  Path find_shortest_path(const GraphSnapshot& graph,
                           const VertexId& source_vertex_id,
-                          const VertexId& destination_vertex_id) const;
+                          const VertexId& destination_vertex_id,
+                          QueryBuffers& buffers) const;
+
+  // peak scratch bytes of one find_shortest_path call so far
+  size_t get_query_memory_usage() const { return max_query_memory_usage_; }
+
+  // peak scratch bytes of traverse_graph, whose workers each run a query
+  size_t memory_usage() const;
 
-  GraphTraverser(const Graph& graph) : graph_(graph) {}
+  // every find_shortest_path call is timed into recorder when it is given
+  GraphTraverser(const GraphSnapshot& graph,
+                 phase_timers::Recorder* recorder = nullptr)
+      : graph_(graph), recorder_(recorder) {}
 
  private:
-  const Graph& graph_;
+  const GraphSnapshot graph_;
+  phase_timers::Recorder* const recorder_;
+  mutable std::atomic<size_t> max_query_memory_usage_ = 0;
+  size_t workers_count_ = 0;
 };
 
 }  // namespace uni_cpp_practice
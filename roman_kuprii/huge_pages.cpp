@@ -0,0 +1,176 @@
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <new>
+#include <optional>
+#include <unordered_map>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#define HUGE_PAGES_HAS_MMAP
+#endif
+
+#include "huge_pages.hpp"
+
+namespace {
+
+using uni_cpp_practice::huge_pages::Backing;
+using uni_cpp_practice::huge_pages::Mode;
+
+constexpr size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+
+std::atomic<Mode> huge_pages_mode = Mode::Off;
+std::array<std::atomic<size_t>, uni_cpp_practice::huge_pages::BACKINGS_COUNT>
+    allocated_bytes = {};
+std::array<std::atomic<size_t>, uni_cpp_practice::huge_pages::BACKINGS_COUNT>
+    peak_bytes = {};
+
+size_t round_to_huge_pages(size_t bytes) {
+  return (bytes + HUGE_PAGE_SIZE - 1) / HUGE_PAGE_SIZE * HUGE_PAGE_SIZE;
+}
+
+void count_allocation(Backing backing, size_t bytes) {
+  const int index = static_cast<int>(backing);
+  const size_t live_bytes = allocated_bytes[index] += bytes;
+  size_t current_peak = peak_bytes[index];
+  while (current_peak < live_bytes &&
+         !peak_bytes[index].compare_exchange_weak(current_peak, live_bytes)) {
+  }
+}
+
+void count_deallocation(Backing backing, size_t bytes) {
+  allocated_bytes[static_cast<int>(backing)] -= bytes;
+}
+
+#ifdef HUGE_PAGES_HAS_MMAP
+
+// backing of every mapped allocation by its address, so a release finds
+// its mapping even after the mode changed
+std::mutex mappings_mutex;
+std::unordered_map<void*, Backing>& get_mappings() {
+  static std::unordered_map<void*, Backing> mappings;
+  return mappings;
+}
+
+void* add_mapping(void* pointer, Backing backing, size_t bytes) {
+  {
+    const std::lock_guard lock(mappings_mutex);
+    get_mappings().emplace(pointer, backing);
+  }
+  count_allocation(backing, bytes);
+  return pointer;
+}
+
+std::optional<Backing> take_mapping(void* pointer) {
+  const std::lock_guard lock(mappings_mutex);
+  auto& mappings = get_mappings();
+  const auto mapping = mappings.find(pointer);
+  if (mapping == mappings.end())
+    return std::nullopt;
+  const Backing backing = mapping->second;
+  mappings.erase(mapping);
+  return backing;
+}
+
+void* map_anonymous(size_t bytes, int flags) {
+  void* const pointer = mmap(nullptr, bytes, PROT_READ | PROT_WRITE,
+                             MAP_PRIVATE | MAP_ANONYMOUS | flags, -1, 0);
+  return pointer == MAP_FAILED ? nullptr : pointer;
+}
+
+// maps more than needed and trims it, so the mapping starts on a huge page
+// boundary and the kernel can back all of it with transparent huge pages
+void* map_huge_page_aligned(size_t bytes) {
+  auto* const pointer =
+      static_cast<std::byte*>(map_anonymous(bytes + HUGE_PAGE_SIZE, 0));
+  if (pointer == nullptr)
+    return nullptr;
+  const auto address = reinterpret_cast<uintptr_t>(pointer);
+  const size_t head_size =
+      (HUGE_PAGE_SIZE - address % HUGE_PAGE_SIZE) % HUGE_PAGE_SIZE;
+  if (head_size > 0)
+    munmap(pointer, head_size);
+  if (head_size < HUGE_PAGE_SIZE)
+    munmap(pointer + head_size + bytes, HUGE_PAGE_SIZE - head_size);
+  return pointer + head_size;
+}
+
+#endif
+
+}  // namespace
+
+namespace uni_cpp_practice {
+
+namespace huge_pages {
+
+void set_mode(Mode mode) {
+  huge_pages_mode = mode;
+}
+
+Mode get_mode() {
+  return huge_pages_mode;
+}
+
+std::array<size_t, BACKINGS_COUNT> get_allocated_bytes() {
+  std::array<size_t, BACKINGS_COUNT> bytes;
+  for (int backing = 0; backing < BACKINGS_COUNT; backing++)
+    bytes[backing] = allocated_bytes[backing];
+  return bytes;
+}
+
+std::array<size_t, BACKINGS_COUNT> get_peak_bytes() {
+  std::array<size_t, BACKINGS_COUNT> bytes;
+  for (int backing = 0; backing < BACKINGS_COUNT; backing++)
+    bytes[backing] = peak_bytes[backing];
+  return bytes;
+}
+
+void* allocate(size_t bytes) {
+#ifdef HUGE_PAGES_HAS_MMAP
+  const Mode mode = huge_pages_mode;
+  if (mode == Mode::Off || bytes < HUGE_PAGE_SIZE)
+    return ::operator new(bytes);
+
+  const size_t mapped_bytes = round_to_huge_pages(bytes);
+#ifdef MAP_HUGETLB
+  if (mode == Mode::Explicit) {
+    // fails unless huge pages were reserved in /proc/sys/vm/nr_hugepages
+    void* const pointer = map_anonymous(mapped_bytes, MAP_HUGETLB);
+    if (pointer != nullptr)
+      return add_mapping(pointer, Backing::Explicit, mapped_bytes);
+  }
+#endif
+  void* const pointer = map_huge_page_aligned(mapped_bytes);
+  if (pointer == nullptr)
+    throw std::bad_alloc();
+#ifdef MADV_HUGEPAGE
+  // fails when transparent huge pages are disabled in the kernel
+  if (madvise(pointer, mapped_bytes, MADV_HUGEPAGE) == 0)
+    return add_mapping(pointer, Backing::Transparent, mapped_bytes);
+#endif
+  return add_mapping(pointer, Backing::Regular, mapped_bytes);
+#else
+  return ::operator new(bytes);
+#endif
+}
+
+void deallocate(void* pointer, size_t bytes) {
+#ifdef HUGE_PAGES_HAS_MMAP
+  if (bytes >= HUGE_PAGE_SIZE) {
+    const auto backing = take_mapping(pointer);
+    if (backing.has_value()) {
+      const size_t mapped_bytes = round_to_huge_pages(bytes);
+      munmap(pointer, mapped_bytes);
+      count_deallocation(backing.value(), mapped_bytes);
+      return;
+    }
+  }
+#endif
+  ::operator delete(pointer);
+}
+
+}  // namespace huge_pages
+
+}  // namespace uni_cpp_practice
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <new>
+#include <vector>
+
+namespace uni_cpp_practice {
+
+namespace huge_pages {
+
+enum class Mode { Off, Transparent, Explicit };
+
+enum class Backing { Regular, Transparent, Explicit };
+
+constexpr int BACKINGS_COUNT = 3;
+
+// applies to allocations made after the call, Off by default
+void set_mode(Mode mode);
+Mode get_mode();
+
+// bytes currently mapped with every backing and the high-water marks of
+// them; allocations served by operator new are not counted
+std::array<size_t, BACKINGS_COUNT> get_allocated_bytes();
+std::array<size_t, BACKINGS_COUNT> get_peak_bytes();
+
+// unless the mode is Off, allocations of at least a huge page are mapped
+// separately, asking for explicit huge pages or transparent ones as the mode
+// says and falling back to regular pages when the system has none to give.
+// Everything else goes to operator new
+void* allocate(size_t bytes);
+void deallocate(void* pointer, size_t bytes);
+
+template <typename T>
+class Allocator {
+ public:
+  using value_type = T;
+
+  Allocator() = default;
+  template <typename U>
+  Allocator(const Allocator<U>&) {}
+
+  T* allocate(size_t count) {
+    return static_cast<T*>(huge_pages::allocate(count * sizeof(T)));
+  }
+  void deallocate(T* pointer, size_t count) {
+    huge_pages::deallocate(pointer, count * sizeof(T));
+  }
+
+  template <typename U>
+  bool operator==(const Allocator<U>&) const {
+    return true;
+  }
+  template <typename U>
+  bool operator!=(const Allocator<U>&) const {
+    return false;
+  }
+};
+
+}  // namespace huge_pages
+
+// vector for the bulk arrays of large graphs
+template <typename T>
+using HugePageVector = std::vector<T, huge_pages::Allocator<T>>;
+
+}  // namespace uni_cpp_practice
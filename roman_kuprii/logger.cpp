@@ -4,6 +4,7 @@
 #include <string>
 
 #include "logger.hpp"
+#include "metrics_exporter.hpp"
 
 namespace uni_cpp_practice {
 
@@ -29,8 +30,10 @@ void Logger::set_output(const std::optional<std::string>& file_path) {
 
 void Logger::log(const std::string& text) {
   std::cout << text << std::endl;
-  if (file_stream_.has_value())
+  if (file_stream_.has_value()) {
     file_stream_.value() << text << std::endl;
+    metrics::get_metrics().log_bytes += text.size() + 1;
+  }
 }
 
 Logger::~Logger() {
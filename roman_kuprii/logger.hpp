@@ -7,8 +7,6 @@
 
 namespace uni_cpp_practice {
 
-class Graph;
-
 class Logger {
  public:
   static Logger& get_logger() {
@@ -1,17 +1,24 @@
 #include <array>
+#include <cstddef>
 #include <chrono>
 #include <fstream>
 #include <iomanip>
 #include <iostream>
 #include <memory>
+#include <optional>
 #include <sstream>
 #include <string>
 #include <vector>
 
+#include "allocation_tracker.hpp"
 #include "graph.hpp"
 #include "graph_printing.hpp"
 #include "graph_traverser.hpp"
+#include "huge_pages.hpp"
 #include "logger.hpp"
+#include "metrics_exporter.hpp"
+#include "phase_timers.hpp"
+#include "profiled_mutex.hpp"
 
 namespace {
 
@@ -34,12 +41,16 @@ namespace uni_cpp_practice {
 
 namespace logging_helping {
 
-void write_graph(const Graph& graph, int graph_num) {
+void write_graph(const Graph& graph,
+                 int graph_num,
+                 phase_timers::Recorder* recorder = nullptr) {
   std::ofstream out;
   const std::string filename =
       JSON_GRAPH_FILENAME + std::to_string(graph_num) + ".json";
   out.open(filename, std::ofstream::out | std::ofstream::trunc);
-  out << graph_printing::graph_to_json(graph);
+  const auto json = graph_printing::graph_to_json(graph, recorder);
+  out << json;
+  metrics::get_metrics().graph_json_bytes += json.size();
   out.close();
 }
 
@@ -49,7 +60,59 @@ std::string write_log_start(int graph_num) {
   return res;
 }
 
-std::string write_log_end(const Graph& work_graph, int graph_num) {
+std::string write_memory_usage(const Graph::MemoryUsage& memory_usage) {
+  std::string res = "  memory: {";
+  res += "vertices: " + to_string(memory_usage.vertices) + ", ";
+  res += "vertex_edge_lists: " + to_string(memory_usage.vertex_edge_lists) +
+         ", ";
+  res += "edges: " + to_string(memory_usage.edges) + ", ";
+  res += "adjacency: " + to_string(memory_usage.adjacency) + ", ";
+  res += "edge_columns: " + to_string(memory_usage.edge_columns) + ", ";
+  res += "depth_map: " + to_string(memory_usage.depth_map) + ", ";
+  res += "total: " + to_string(memory_usage.get_total()) + "}";
+  return res;
+}
+
+std::string write_allocation_stats(
+    const allocation_tracking::AllocationStats& stats) {
+  std::string res = "{";
+  res += "count: " + to_string(stats.allocations) + ", ";
+  res += "bytes: " + to_string(stats.allocated_bytes) + ", ";
+  res += "frees: " + to_string(stats.deallocations) + ", ";
+  res += "freed_bytes: " + to_string(stats.freed_bytes) + ", ";
+  res += "peak_bytes: " + to_string(stats.peak_bytes) + "}";
+  return res;
+}
+
+// totals of the job and of every phase that allocated or freed anything
+std::string write_job_allocations(
+    const allocation_tracking::JobAllocations& allocations) {
+  std::string res =
+      "  allocations: " + write_allocation_stats(allocations.get_total());
+  const auto phases = allocations.get_phases();
+  std::string phases_res;
+  for (int phase = 0; phase < phase_timers::PHASES_COUNT; phase++) {
+    if (phases[phase].allocations == 0 && phases[phase].deallocations == 0)
+      continue;
+    phases_res += "    " +
+                  phase_timers::phase_to_string(
+                      static_cast<phase_timers::Phase>(phase)) +
+                  ": " + write_allocation_stats(phases[phase]) + ",\n";
+  }
+  if (phases_res.size()) {
+    phases_res.pop_back();
+    phases_res.pop_back();
+    res += ",\n  allocations_by_phase: {\n" + phases_res + "\n  }";
+  }
+  return res;
+}
+
+// allocations are reported as far as the job got when the log is written
+std::string write_log_end(
+    const Graph& work_graph,
+    int graph_num,
+    bool with_memory_usage = false,
+    const allocation_tracking::JobAllocations* allocations = nullptr) {
   std::string res = get_datetime();
   res += ": Graph " + to_string(graph_num) + ", Generation Ended {\n";
   res += "  depth: " + to_string(work_graph.get_depth()) + ",\n";
@@ -69,11 +132,126 @@ std::string write_log_end(const Graph& work_graph, int graph_num) {
 
   for (const auto& color : colors) {
     res += graph_printing::color_to_string(color) + ": " +
-           to_string(work_graph.get_edge_ids_with_color(color).size()) + ", ";
+           to_string(work_graph.get_edges_count_with_color(color)) + ", ";
   }
   res.pop_back();
   res.pop_back();
-  res += "}\n}\n";
+  res += "}";
+  if (with_memory_usage)
+    res += ",\n" + write_memory_usage(work_graph.memory_usage());
+  if (allocations != nullptr)
+    res += ",\n" + write_job_allocations(*allocations);
+  res += "\n}\n";
+  return res;
+}
+
+std::string write_huge_pages_usage() {
+  const auto allocated_bytes = huge_pages::get_allocated_bytes();
+  const auto peak_bytes = huge_pages::get_peak_bytes();
+  const auto write_backing = [&allocated_bytes,
+                              &peak_bytes](huge_pages::Backing backing) {
+    const int index = static_cast<int>(backing);
+    return "{live: " + to_string(allocated_bytes[index]) +
+           ", peak: " + to_string(peak_bytes[index]) + "}";
+  };
+  std::string res = get_datetime();
+  res += ": Huge Pages {regular: ";
+  res += write_backing(huge_pages::Backing::Regular);
+  res += ", transparent: ";
+  res += write_backing(huge_pages::Backing::Transparent);
+  res += ", explicit: ";
+  res += write_backing(huge_pages::Backing::Explicit);
+  res += "}";
+  return res;
+}
+
+// count, total and percentiles of every timed phase, in microseconds
+std::string write_phase_histograms(
+    const phase_timers::Recorder::Histograms& histograms) {
+  const auto to_microseconds = [](uint64_t nanoseconds) {
+    std::stringstream microseconds;
+    microseconds << std::fixed << std::setprecision(1)
+                 << static_cast<double>(nanoseconds) / 1000;
+    return microseconds.str();
+  };
+  std::string res;
+  for (int phase = 0; phase < phase_timers::PHASES_COUNT; phase++) {
+    const auto& histogram = histograms[phase];
+    if (histogram.get_count() == 0)
+      continue;
+    res += "  " +
+           phase_timers::phase_to_string(static_cast<phase_timers::Phase>(
+               phase)) +
+           ": {";
+    res += "count: " + to_string(histogram.get_count()) + ", ";
+    res += "total_us: " +
+           to_microseconds(histogram.get_total_nanoseconds()) + ", ";
+    res += "p50_us: " +
+           to_microseconds(histogram.get_percentile_nanoseconds(50)) + ", ";
+    res += "p99_us: " +
+           to_microseconds(histogram.get_percentile_nanoseconds(99)) + ", ";
+    res += "max_us: " + to_microseconds(histogram.get_max_nanoseconds());
+    res += "},\n";
+  }
+  if (res.size()) {
+    res.pop_back();
+    res.pop_back();
+  }
+  return res;
+}
+
+std::string write_phase_timings(
+    int graph_num,
+    const phase_timers::Recorder::Histograms& histograms) {
+  std::string res = get_datetime();
+  res += ": Graph " + to_string(graph_num) + ", Phase Timings {\n";
+  res += write_phase_histograms(histograms);
+  res += "\n}\n";
+  return res;
+}
+
+std::string write_run_phase_timings() {
+  std::string res = get_datetime();
+  res += ": Run Phase Timings {\n";
+  res += write_phase_histograms(
+      phase_timers::get_run_recorder().get_histograms());
+  res += "\n}\n";
+  return res;
+}
+
+std::string write_run_allocations() {
+  std::string res = get_datetime();
+  res += ": Run Allocations ";
+  res += write_allocation_stats(allocation_tracking::get_run_stats());
+  return res;
+}
+
+std::string write_lock_stats() {
+  const auto to_microseconds = [](uint64_t nanoseconds) {
+    std::stringstream microseconds;
+    microseconds << std::fixed << std::setprecision(1)
+                 << static_cast<double>(nanoseconds) / 1000;
+    return microseconds.str();
+  };
+  std::string res = get_datetime();
+  res += ": Lock Contention {\n";
+  const auto lock_stats = lock_profiling::get_stats();
+  for (const auto& [name, stats] : lock_stats) {
+    res += "  " + name + ": {";
+    res += "acquisitions: " + to_string(stats.acquisitions) + ", ";
+    res += "contended: " + to_string(stats.contended_acquisitions) + ", ";
+    res += "wait_us: " + to_microseconds(stats.wait_nanoseconds) + ", ";
+    res += "max_wait_us: " + to_microseconds(stats.max_wait_nanoseconds) +
+           ", ";
+    res += "hold_us: " + to_microseconds(stats.hold_nanoseconds) + ", ";
+    res += "max_hold_us: " + to_microseconds(stats.max_hold_nanoseconds);
+    res += "},\n";
+  }
+  if (lock_stats.size()) {
+    res.pop_back();
+    res.pop_back();
+  }
+  res += "\n}\n";
   return res;
 }
 
@@ -85,9 +263,14 @@ std::string write_traverse_start(int graph_num) {
 
 std::string write_traverse_end(
     int graph_num,
-    const std::vector<GraphTraverser::Path>& pathes) {
+    const std::vector<GraphTraverser::Path>& pathes,
+    std::optional<size_t> memory_usage = std::nullopt,
+    const allocation_tracking::JobAllocations* allocations = nullptr) {
   std::string res = get_datetime();
-  res += ": Graph " + to_string(graph_num) + ", Traversal Finished, Paths: [\n";
+  res += ": Graph " + to_string(graph_num) + ", Traversal Finished";
+  if (memory_usage.has_value())
+    res += ", Memory: " + to_string(memory_usage.value());
+  res += ", Paths: [\n";
   for (const auto& path : pathes) {
     res += "  ";
     res += graph_printing::path_to_json(path);
@@ -98,6 +281,8 @@ std::string write_traverse_end(
     res.pop_back();
   }
   res += "\n]\n";
+  if (allocations != nullptr)
+    res += "Allocations {\n" + write_job_allocations(*allocations) + "\n}\n";
   return res;
 }
 
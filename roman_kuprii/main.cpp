@@ -1,28 +1,66 @@
 #include <filesystem>
 #include <fstream>
 #include <iostream>
+#include <optional>
 #include <string>
 
+#include "allocation_tracker.hpp"
 #include "graph.hpp"
 #include "graph_generation_controller.hpp"
 #include "graph_generator.hpp"
+#include "graph_pool.hpp"
 #include "graph_printing.hpp"
+#include "graph_snapshot.hpp"
 #include "graph_traversal_controller.hpp"
 #include "graph_traverser.hpp"
+#include "huge_pages.hpp"
 #include "logger.hpp"
 #include "logging_helping.hpp"
+#include "metrics_exporter.hpp"
+#include "phase_timers.hpp"
+#include "profiled_mutex.hpp"
+#include "tracer.hpp"
 
 constexpr int GRAPHS_NUMBER = 0;
 constexpr int INVALID_NEW_DEPTH = -1;
 constexpr int INVALID_NEW_VERTICES_NUMBER = -1;
 constexpr int INVALID_THREADS_NUMBER = 0;
 const std::string LOG_FILENAME = "temp/log.txt";
+// chrome trace of all jobs and phases, see chrome://tracing or Perfetto
+const std::string TRACE_FILENAME = "temp/trace.json";
+// prometheus metrics while running, e.g.
+// curl --unix-socket temp/metrics.sock http://localhost/metrics
+const std::string METRICS_SOCKET_PATH = "temp/metrics.sock";
 const std::string DIRECTORY_NAME = "temp";
+// instrumentation switches, all off so a plain run measures only itself;
+// set one to true and rebuild to turn it on
+//
+// adds memory usage of every graph and traversal to the log
+constexpr bool LOG_MEMORY_USAGE = false;
+// adds the phase timings of every graph and of the whole run to the log
+constexpr bool LOG_PHASE_TIMINGS = false;
+// adds waiting for and holding every profiled lock to the log
+constexpr bool LOG_LOCK_CONTENTION = false;
+// counts allocations per job and phase, see write_log_end, and for the run;
+// while on, every operator new and delete updates shared counters
+constexpr bool LOG_ALLOCATIONS = false;
+// serves live metrics on METRICS_SOCKET_PATH from a thread of its own
+constexpr bool SERVE_METRICS = false;
+// records every job and phase of every thread for TRACE_FILENAME, the events
+// are buffered in memory until the run ends
+constexpr bool WRITE_TRACE = false;
+// adds the bytes mapped with every huge page backing to the log
+constexpr bool LOG_HUGE_PAGES_USAGE = false;
+// backing of the bulk arrays of snapshots and traversals
+constexpr auto HUGE_PAGES_MODE =
+    uni_cpp_practice::huge_pages::Mode::Transparent;
 
 const int MAX_THREADS_COUNT = std::thread::hardware_concurrency();
 
 using uni_cpp_practice::Graph;
 using uni_cpp_practice::GraphGenerator;
+using uni_cpp_practice::GraphPool;
+using uni_cpp_practice::GraphSnapshot;
 using uni_cpp_practice::GraphTraverser;
 using uni_cpp_practice::Logger;
 using uni_cpp_practice::graph_generation_controller::GraphGenerationController;
@@ -70,11 +108,12 @@ void prepare_temp_directory() {
   std::filesystem::create_directory(DIRECTORY_NAME);
 }
 
-std::vector<Graph> generate_graphs(Logger& logger,
-                                   const int threads_count,
-                                   const int graphs_count,
-                                   const GraphGenerator::Params& params) {
-  auto graphs = std::vector<Graph>();
+std::vector<GraphSnapshot> generate_graphs(
+    Logger& logger,
+    const int threads_count,
+    const int graphs_count,
+    const GraphGenerator::Params& params) {
+  auto graphs = std::vector<GraphSnapshot>();
   graphs.reserve(graphs_count);
 
   auto generation_controller =
@@ -83,28 +122,46 @@ std::vector<Graph> generate_graphs(Logger& logger,
       [&logger](int index) {
         logger.log(uni_cpp_practice::logging_helping::write_log_start(index));
       },
-      [&logger, &graphs](const Graph& graph, int index) {
-        logger.log(
-            uni_cpp_practice::logging_helping::write_log_end(graph, index));
-        graphs.push_back(graph);
-        uni_cpp_practice::logging_helping::write_graph(graph, index);
+      [&logger, &graphs, &generation_controller](GraphPool::Handle graph,
+                                                 int index) {
+        // written first, so its json phase is part of the logged job
+        uni_cpp_practice::logging_helping::write_graph(
+            *graph, index, generation_controller.get_phase_recorder(index));
+        logger.log(uni_cpp_practice::logging_helping::write_log_end(
+            *graph, index, LOG_MEMORY_USAGE,
+            LOG_ALLOCATIONS ? &generation_controller.get_allocations(index)
+                            : nullptr));
+        if (LOG_PHASE_TIMINGS)
+          logger.log(uni_cpp_practice::logging_helping::write_phase_timings(
+              index, generation_controller.get_phase_timings(index)));
+        graphs.push_back(GraphSnapshot::freeze(*graph));
       });
 
   return graphs;
 }
 
-void traverse_graphs(const std::vector<Graph>& graphs,
+void traverse_graphs(std::vector<GraphSnapshot> graphs,
                      Logger& logger,
                      const int threads_count) {
-  auto traversal_controller = GraphTraversalController(threads_count, graphs);
+  auto traversal_controller =
+      GraphTraversalController(threads_count, std::move(graphs));
   traversal_controller.traverse_graphs(
       [&logger](int index) {
         logger.log(
             uni_cpp_practice::logging_helping::write_traverse_start(index));
       },
-      [&logger](int index, const std::vector<GraphTraverser::Path>& pathes) {
+      [&logger, &traversal_controller](
+          int index, const std::vector<GraphTraverser::Path>& pathes,
+          size_t memory_usage) {
         logger.log(uni_cpp_practice::logging_helping::write_traverse_end(
-            index, pathes));
+            index, pathes,
+            LOG_MEMORY_USAGE ? std::optional<size_t>(memory_usage)
+                             : std::nullopt,
+            LOG_ALLOCATIONS ? &traversal_controller.get_allocations(index)
+                            : nullptr));
+        if (LOG_PHASE_TIMINGS)
+          logger.log(uni_cpp_practice::logging_helping::write_phase_timings(
+              index, traversal_controller.get_phase_timings(index)));
       });
 }
 
@@ -112,6 +169,19 @@ int main() {
   auto& logger = Logger::get_logger();
   prepare_temp_directory();
   logger.set_output(LOG_FILENAME);
+  uni_cpp_practice::huge_pages::set_mode(HUGE_PAGES_MODE);
+  uni_cpp_practice::tracer::set_enabled(WRITE_TRACE);
+  // the exported metrics are fed by the same recorders
+  uni_cpp_practice::phase_timers::set_enabled(LOG_PHASE_TIMINGS ||
+                                              SERVE_METRICS);
+  uni_cpp_practice::lock_profiling::set_enabled(LOG_LOCK_CONTENTION);
+  uni_cpp_practice::allocation_tracking::set_enabled(LOG_ALLOCATIONS);
+  std::optional<uni_cpp_practice::metrics::Exporter> metrics_exporter;
+  if (SERVE_METRICS) {
+    metrics_exporter.emplace(METRICS_SOCKET_PATH);
+    if (!metrics_exporter->is_running())
+      logger.log("Metrics are not served: " + metrics_exporter->get_error());
+  }
 
   const int graphs_count = handle_graphs_number_input();
   const int depth = handle_depth_input();
@@ -120,7 +190,17 @@ int main() {
   const auto params = GraphGenerator::Params(depth, new_vertices_num);
 
   auto graphs = generate_graphs(logger, threads_count, graphs_count, params);
-  traverse_graphs(graphs, logger, threads_count);
+  traverse_graphs(std::move(graphs), logger, threads_count);
+  if (LOG_HUGE_PAGES_USAGE)
+    logger.log(uni_cpp_practice::logging_helping::write_huge_pages_usage());
+  if (LOG_PHASE_TIMINGS)
+    logger.log(uni_cpp_practice::logging_helping::write_run_phase_timings());
+  if (LOG_ALLOCATIONS)
+    logger.log(uni_cpp_practice::logging_helping::write_run_allocations());
+  if (LOG_LOCK_CONTENTION)
+    logger.log(uni_cpp_practice::logging_helping::write_lock_stats());
+  if (WRITE_TRACE)
+    uni_cpp_practice::tracer::write_chrome_trace(TRACE_FILENAME);
 
   return 0;
 }
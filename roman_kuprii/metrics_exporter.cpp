@@ -0,0 +1,260 @@
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <sstream>
+#include <string>
+#include <thread>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#define METRICS_EXPORTER_HAS_UNIX_SOCKETS
+#endif
+
+#include "metrics_exporter.hpp"
+#include "phase_timers.hpp"
+
+namespace uni_cpp_practice {
+
+namespace metrics {
+
+namespace {
+
+// how long the serving thread waits before it checks for termination
+constexpr int POLL_TIMEOUT_MILLISECONDS = 200;
+// how long a connection may take to send its request, if any
+constexpr int REQUEST_TIMEOUT_MILLISECONDS = 100;
+constexpr int MAX_REQUEST_SIZE = 4096;
+
+std::string to_seconds(uint64_t nanoseconds) {
+  std::ostringstream seconds;
+  seconds << static_cast<double>(nanoseconds) / 1e9;
+  return seconds.str();
+}
+
+void write_header(std::string& res,
+                  const std::string& name,
+                  const std::string& type,
+                  const std::string& help) {
+  res += "# HELP " + name + " " + help + "\n";
+  res += "# TYPE " + name + " " + type + "\n";
+}
+
+void write_controller_samples(std::string& res,
+                              const std::string& name,
+                              const std::atomic<uint64_t>& generation_value,
+                              const std::atomic<uint64_t>& traversal_value) {
+  res += name + "{controller=\"generation\"} " +
+         std::to_string(generation_value.load()) + "\n";
+  res += name + "{controller=\"traversal\"} " +
+         std::to_string(traversal_value.load()) + "\n";
+}
+
+void write_controller_samples(std::string& res,
+                              const std::string& name,
+                              const std::atomic<int64_t>& generation_value,
+                              const std::atomic<int64_t>& traversal_value) {
+  res += name + "{controller=\"generation\"} " +
+         std::to_string(generation_value.load()) + "\n";
+  res += name + "{controller=\"traversal\"} " +
+         std::to_string(traversal_value.load()) + "\n";
+}
+
+}  // namespace
+
+void PhaseHistogram::observe(uint64_t nanoseconds) {
+  int bucket = 0;
+  while (bucket < static_cast<int>(BUCKET_BOUNDS.size()) &&
+         nanoseconds > BUCKET_BOUNDS[bucket])
+    bucket++;
+  buckets_[bucket].fetch_add(1, std::memory_order_relaxed);
+  total_nanoseconds_.fetch_add(nanoseconds, std::memory_order_relaxed);
+  count_.fetch_add(1, std::memory_order_relaxed);
+}
+
+std::array<uint64_t, PhaseHistogram::BUCKET_BOUNDS.size() + 1>
+PhaseHistogram::get_bucket_counts() const {
+  std::array<uint64_t, BUCKET_BOUNDS.size() + 1> res;
+  for (int bucket = 0; bucket < static_cast<int>(res.size()); bucket++)
+    res[bucket] = buckets_[bucket].load(std::memory_order_relaxed);
+  return res;
+}
+
+Metrics& get_metrics() {
+  static Metrics metrics;
+  return metrics;
+}
+
+std::string to_prometheus_text() {
+  const auto& metrics = get_metrics();
+  std::string res;
+
+  write_header(res, "graphs_completed_jobs_total", "counter",
+               "Graphs generated or traversed so far.");
+  write_controller_samples(res, "graphs_completed_jobs_total",
+                           metrics.generation.completed_jobs,
+                           metrics.traversal.completed_jobs);
+  write_header(res, "graphs_queue_depth", "gauge",
+               "Jobs waiting for a worker.");
+  write_controller_samples(res, "graphs_queue_depth",
+                           metrics.generation.queue_depth,
+                           metrics.traversal.queue_depth);
+  write_header(res, "graphs_active_workers", "gauge",
+               "Workers running a job.");
+  write_controller_samples(res, "graphs_active_workers",
+                           metrics.generation.active_workers,
+                           metrics.traversal.active_workers);
+
+  write_header(res, "graphs_phase_duration_seconds", "histogram",
+               "Duration of every timed phase.");
+  for (int phase = 0; phase < phase_timers::PHASES_COUNT; phase++) {
+    const auto& histogram = metrics.phases[phase];
+    const auto label =
+        "phase=\"" +
+        phase_timers::phase_to_string(static_cast<phase_timers::Phase>(phase)) +
+        "\"";
+    // the count may lag the buckets while a duration is being added, the
+    // larger of both keeps the buckets cumulative
+    const auto bucket_counts = histogram.get_bucket_counts();
+    const auto total_nanoseconds = histogram.get_total_nanoseconds();
+    uint64_t cumulative_count = 0;
+    for (int bucket = 0;
+         bucket < static_cast<int>(PhaseHistogram::BUCKET_BOUNDS.size());
+         bucket++) {
+      cumulative_count += bucket_counts[bucket];
+      res += "graphs_phase_duration_seconds_bucket{" + label + ",le=\"" +
+             to_seconds(PhaseHistogram::BUCKET_BOUNDS[bucket]) + "\"} " +
+             std::to_string(cumulative_count) + "\n";
+    }
+    cumulative_count += bucket_counts.back();
+    const auto count = std::max(histogram.get_count(), cumulative_count);
+    res += "graphs_phase_duration_seconds_bucket{" + label + ",le=\"+Inf\"} " +
+           std::to_string(count) + "\n";
+    res += "graphs_phase_duration_seconds_sum{" + label + "} " +
+           to_seconds(total_nanoseconds) + "\n";
+    res += "graphs_phase_duration_seconds_count{" + label + "} " +
+           std::to_string(count) + "\n";
+  }
+
+  write_header(res, "graphs_written_bytes_total", "counter",
+               "Bytes written to the graph json files and to the log.");
+  res += "graphs_written_bytes_total{output=\"graph_json\"} " +
+         std::to_string(metrics.graph_json_bytes.load()) + "\n";
+  res += "graphs_written_bytes_total{output=\"log\"} " +
+         std::to_string(metrics.log_bytes.load()) + "\n";
+  return res;
+}
+
+#if defined(METRICS_EXPORTER_HAS_UNIX_SOCKETS)
+
+namespace {
+
+void send_all(int connection_fd, const std::string& text) {
+  size_t sent = 0;
+  while (sent < text.size()) {
+#if defined(MSG_NOSIGNAL)
+    const auto result = send(connection_fd, text.data() + sent,
+                             text.size() - sent, MSG_NOSIGNAL);
+#else
+    const auto result =
+        send(connection_fd, text.data() + sent, text.size() - sent, 0);
+#endif
+    if (result <= 0)
+      return;
+    sent += result;
+  }
+}
+
+void serve_connection(int connection_fd) {
+  // a plain client may send nothing and just read
+  std::string request;
+  pollfd connection_poll = {connection_fd, POLLIN, 0};
+  if (poll(&connection_poll, 1, REQUEST_TIMEOUT_MILLISECONDS) > 0) {
+    char buffer[MAX_REQUEST_SIZE];
+    const auto result = read(connection_fd, buffer, sizeof(buffer));
+    if (result > 0)
+      request.assign(buffer, result);
+  }
+  const auto body = to_prometheus_text();
+  if (request.rfind("GET ", 0) == 0) {
+    send_all(connection_fd,
+             "HTTP/1.0 200 OK\r\n"
+             "Content-Type: text/plain; version=0.0.4\r\n"
+             "Content-Length: " +
+                 std::to_string(body.size()) + "\r\n\r\n");
+  }
+  send_all(connection_fd, body);
+}
+
+}  // namespace
+
+Exporter::Exporter(const std::string& socket_path)
+    : socket_path_(socket_path) {
+  sockaddr_un address;
+  std::memset(&address, 0, sizeof(address));
+  address.sun_family = AF_UNIX;
+  if (socket_path.size() >= sizeof(address.sun_path)) {
+    error_ = "socket path is too long";
+    return;
+  }
+  std::strncpy(address.sun_path, socket_path.c_str(),
+               sizeof(address.sun_path) - 1);
+
+  const int socket_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+  if (socket_fd == -1) {
+    error_ = std::string("socket: ") + std::strerror(errno);
+    return;
+  }
+  unlink(socket_path.c_str());
+  if (bind(socket_fd, reinterpret_cast<sockaddr*>(&address),
+           sizeof(address)) == -1 ||
+      listen(socket_fd, SOMAXCONN) == -1) {
+    error_ = socket_path + ": " + std::strerror(errno);
+    close(socket_fd);
+    return;
+  }
+  socket_fd_ = socket_fd;
+  thread_ = std::thread([this]() { serve(); });
+}
+
+Exporter::~Exporter() {
+  if (!is_running())
+    return;
+  should_terminate_ = true;
+  thread_.join();
+  close(socket_fd_);
+  unlink(socket_path_.c_str());
+}
+
+void Exporter::serve() {
+  while (!should_terminate_) {
+    pollfd socket_poll = {socket_fd_, POLLIN, 0};
+    if (poll(&socket_poll, 1, POLL_TIMEOUT_MILLISECONDS) <= 0)
+      continue;
+    const int connection_fd = accept(socket_fd_, nullptr, nullptr);
+    if (connection_fd == -1)
+      continue;
+    serve_connection(connection_fd);
+    close(connection_fd);
+  }
+}
+
+#else
+
+Exporter::Exporter(const std::string& socket_path)
+    : socket_path_(socket_path), error_("unix domain sockets are missing") {}
+
+Exporter::~Exporter() {}
+
+void Exporter::serve() {}
+
+#endif
+
+}  // namespace metrics
+
+}  // namespace uni_cpp_practice
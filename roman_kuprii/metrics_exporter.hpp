@@ -0,0 +1,110 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <thread>
+
+#include "phase_timers.hpp"
+
+namespace uni_cpp_practice {
+
+namespace metrics {
+
+// durations in fixed buckets, updated without locks so a scrape never waits
+// for the workers and the workers never wait for a scrape
+class PhaseHistogram {
+ public:
+  // upper bounds of the buckets in nanoseconds, 1us to 10s in 1-2.5-5 steps
+  static constexpr std::array<uint64_t, 22> BUCKET_BOUNDS = {
+      1'000,         2'500,         5'000,          10'000,
+      25'000,        50'000,        100'000,        250'000,
+      500'000,       1'000'000,     2'500'000,      5'000'000,
+      10'000'000,    25'000'000,    50'000'000,     100'000'000,
+      250'000'000,   500'000'000,   1'000'000'000,  2'500'000'000,
+      5'000'000'000, 10'000'000'000};
+
+  void observe(uint64_t nanoseconds);
+
+  // counts of every bucket and of the overflow one, not cumulative
+  std::array<uint64_t, BUCKET_BOUNDS.size() + 1> get_bucket_counts() const;
+  uint64_t get_count() const { return count_; }
+  uint64_t get_total_nanoseconds() const { return total_nanoseconds_; }
+
+ private:
+  std::array<std::atomic<uint64_t>, BUCKET_BOUNDS.size() + 1> buckets_ = {};
+  std::atomic<uint64_t> count_ = 0;
+  std::atomic<uint64_t> total_nanoseconds_ = 0;
+};
+
+struct ControllerMetrics {
+  std::atomic<uint64_t> completed_jobs = 0;
+  // jobs waiting for a worker
+  std::atomic<int64_t> queue_depth = 0;
+  // workers running a job right now
+  std::atomic<int64_t> active_workers = 0;
+};
+
+struct Metrics {
+  ControllerMetrics generation;
+  ControllerMetrics traversal;
+  std::array<PhaseHistogram, phase_timers::PHASES_COUNT> phases;
+  std::atomic<uint64_t> graph_json_bytes = 0;
+  std::atomic<uint64_t> log_bytes = 0;
+};
+
+// metrics of the whole process, always collected, exported only by Exporter
+Metrics& get_metrics();
+
+// counts a running job in the gauge for the lifetime of the scope
+class ScopedActiveWorker {
+ public:
+  explicit ScopedActiveWorker(ControllerMetrics& controller_metrics)
+      : active_workers_(controller_metrics.active_workers) {
+    active_workers_.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  ScopedActiveWorker(const ScopedActiveWorker&) = delete;
+  ScopedActiveWorker& operator=(const ScopedActiveWorker&) = delete;
+
+  ~ScopedActiveWorker() {
+    active_workers_.fetch_sub(1, std::memory_order_relaxed);
+  }
+
+ private:
+  std::atomic<int64_t>& active_workers_;
+};
+
+// the metrics in prometheus text exposition format
+std::string to_prometheus_text();
+
+// serves to_prometheus_text() on a unix domain socket from its own thread,
+// to every connection: plain text to `nc -U`, an http response to
+// `curl --unix-socket <path> http://localhost/metrics`
+class Exporter {
+ public:
+  // a file at the path is replaced, the socket is removed on destruction
+  explicit Exporter(const std::string& socket_path);
+  ~Exporter();
+
+  Exporter(const Exporter&) = delete;
+  Exporter& operator=(const Exporter&) = delete;
+
+  bool is_running() const { return socket_fd_ != -1; }
+  // why the socket could not be served, empty while running
+  const std::string& get_error() const { return error_; }
+
+ private:
+  void serve();
+
+  const std::string socket_path_;
+  int socket_fd_ = -1;
+  std::string error_;
+  std::atomic<bool> should_terminate_ = false;
+  std::thread thread_;
+};
+
+}  // namespace metrics
+
+}  // namespace uni_cpp_practice
@@ -0,0 +1,120 @@
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+
+#include "metrics_exporter.hpp"
+#include "phase_timers.hpp"
+
+namespace uni_cpp_practice {
+
+namespace phase_timers {
+
+namespace {
+
+std::atomic<bool> is_timing_enabled = false;
+
+int get_bucket_index(uint64_t nanoseconds) {
+  int index = 0;
+  while (nanoseconds > 1 && index + 1 < Histogram::BUCKETS_COUNT) {
+    nanoseconds >>= 1;
+    index++;
+  }
+  return index;
+}
+
+}  // namespace
+
+std::string phase_to_string(Phase phase) {
+  switch (phase) {
+    case Phase::NewVertices:
+      return "new_vertices";
+    case Phase::BlueEdges:
+      return "blue_edges";
+    case Phase::GreenEdges:
+      return "green_edges";
+    case Phase::RedEdges:
+      return "red_edges";
+    case Phase::YellowEdges:
+      return "yellow_edges";
+    case Phase::ShortestPath:
+      return "shortest_path";
+    case Phase::GraphToJson:
+      return "graph_to_json";
+  }
+  throw std::logic_error("Unknown phase");
+}
+
+void Histogram::add(uint64_t nanoseconds) {
+  buckets_[get_bucket_index(nanoseconds)]++;
+  min_nanoseconds_ =
+      count_ == 0 ? nanoseconds : std::min(min_nanoseconds_, nanoseconds);
+  max_nanoseconds_ = std::max(max_nanoseconds_, nanoseconds);
+  total_nanoseconds_ += nanoseconds;
+  count_++;
+}
+
+void Histogram::merge(const Histogram& histogram) {
+  if (histogram.count_ == 0)
+    return;
+  for (int i = 0; i < BUCKETS_COUNT; i++)
+    buckets_[i] += histogram.buckets_[i];
+  min_nanoseconds_ =
+      count_ == 0 ? histogram.min_nanoseconds_
+                  : std::min(min_nanoseconds_, histogram.min_nanoseconds_);
+  max_nanoseconds_ = std::max(max_nanoseconds_, histogram.max_nanoseconds_);
+  total_nanoseconds_ += histogram.total_nanoseconds_;
+  count_ += histogram.count_;
+}
+
+uint64_t Histogram::get_percentile_nanoseconds(double percentile) const {
+  if (count_ == 0)
+    return 0;
+  const uint64_t rank = std::max<uint64_t>(
+      std::ceil(percentile / 100 * static_cast<double>(count_)), 1);
+  uint64_t seen = 0;
+  for (int i = 0; i < BUCKETS_COUNT; i++) {
+    seen += buckets_[i];
+    if (seen >= rank)
+      return std::min(max_nanoseconds_, (uint64_t{1} << (i + 1)) - 1);
+  }
+  return max_nanoseconds_;
+}
+
+void Recorder::record(Phase phase, uint64_t nanoseconds) {
+  {
+    const std::lock_guard lock(mutex_);
+    histograms_[static_cast<int>(phase)].add(nanoseconds);
+  }
+  if (parent_ != nullptr)
+    parent_->record(phase, nanoseconds);
+  else
+    metrics::get_metrics().phases[static_cast<int>(phase)].observe(
+        nanoseconds);
+}
+
+Recorder::Histograms Recorder::get_histograms() const {
+  const std::lock_guard lock(mutex_);
+  return histograms_;
+}
+
+Recorder& get_run_recorder() {
+  static Recorder run_recorder;
+  return run_recorder;
+}
+
+void set_enabled(bool is_enabled) {
+  is_timing_enabled = is_enabled;
+}
+
+bool is_enabled() {
+  return is_timing_enabled.load(std::memory_order_relaxed);
+}
+
+}  // namespace phase_timers
+
+}  // namespace uni_cpp_practice
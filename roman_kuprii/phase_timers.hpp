@@ -0,0 +1,113 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+
+namespace uni_cpp_practice {
+
+namespace phase_timers {
+
+enum class Phase {
+  NewVertices,
+  BlueEdges,
+  GreenEdges,
+  RedEdges,
+  YellowEdges,
+  ShortestPath,
+  GraphToJson
+};
+
+constexpr int PHASES_COUNT = 7;
+
+std::string phase_to_string(Phase phase);
+
+// durations in power of two buckets, bucket i counts [2^i, 2^(i + 1)) ns
+class Histogram {
+ public:
+  static constexpr int BUCKETS_COUNT = 40;
+
+  void add(uint64_t nanoseconds);
+  void merge(const Histogram& histogram);
+
+  uint64_t get_count() const { return count_; }
+  uint64_t get_total_nanoseconds() const { return total_nanoseconds_; }
+  uint64_t get_min_nanoseconds() const { return min_nanoseconds_; }
+  uint64_t get_max_nanoseconds() const { return max_nanoseconds_; }
+  const std::array<uint64_t, BUCKETS_COUNT>& get_buckets() const {
+    return buckets_;
+  }
+
+  // upper bound of the bucket holding the percentile, at most the max
+  uint64_t get_percentile_nanoseconds(double percentile) const;
+
+ private:
+  std::array<uint64_t, BUCKETS_COUNT> buckets_ = {};
+  uint64_t count_ = 0;
+  uint64_t total_nanoseconds_ = 0;
+  uint64_t min_nanoseconds_ = 0;
+  uint64_t max_nanoseconds_ = 0;
+};
+
+// histograms of every phase, filled from any thread; every duration is
+// reported to the parent as well, so per-graph recorders add up to a run.
+// Recorders without a parent report to the exported metrics
+class Recorder {
+ public:
+  using Histograms = std::array<Histogram, PHASES_COUNT>;
+
+  explicit Recorder(Recorder* parent = nullptr) : parent_(parent) {}
+
+  Recorder(const Recorder&) = delete;
+  Recorder& operator=(const Recorder&) = delete;
+
+  void record(Phase phase, uint64_t nanoseconds);
+
+  Histograms get_histograms() const;
+
+ private:
+  Recorder* const parent_;
+  mutable std::mutex mutex_;
+  Histograms histograms_;
+};
+
+// recorder of the whole process, the controllers' recorders report to it
+Recorder& get_run_recorder();
+
+// the controllers give their jobs recorders only while timing is enabled, it
+// is off by default
+void set_enabled(bool is_enabled);
+bool is_enabled();
+
+// records the lifetime of the scope, does nothing without a recorder
+class ScopedTimer {
+ public:
+  ScopedTimer(Recorder* recorder, Phase phase)
+      : recorder_(recorder),
+        phase_(phase),
+        start_(recorder ? std::chrono::steady_clock::now()
+                        : std::chrono::steady_clock::time_point()) {}
+
+  ScopedTimer(const ScopedTimer&) = delete;
+  ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+  ~ScopedTimer() {
+    if (recorder_ == nullptr)
+      return;
+    const auto duration = std::chrono::steady_clock::now() - start_;
+    recorder_->record(
+        phase_,
+        std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count());
+  }
+
+ private:
+  Recorder* const recorder_;
+  const Phase phase_;
+  const std::chrono::steady_clock::time_point start_;
+};
+
+}  // namespace phase_timers
+
+}  // namespace uni_cpp_practice
@@ -0,0 +1,110 @@
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "profiled_mutex.hpp"
+
+namespace uni_cpp_practice {
+
+namespace {
+
+std::atomic<bool> is_profiling_enabled = false;
+
+// stats live as long as the process, so mutexes keep a plain reference
+std::mutex stats_mutex;
+std::map<std::string, std::unique_ptr<ProfiledMutex::Stats>> stats_by_name;
+
+int64_t get_timestamp() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+void update_max(std::atomic<uint64_t>& max_value, uint64_t value) {
+  uint64_t current_max = max_value;
+  while (current_max < value &&
+         !max_value.compare_exchange_weak(current_max, value)) {
+  }
+}
+
+}  // namespace
+
+namespace lock_profiling {
+
+void set_enabled(bool is_enabled) {
+  is_profiling_enabled = is_enabled;
+}
+
+bool is_enabled() {
+  return is_profiling_enabled.load(std::memory_order_relaxed);
+}
+
+std::map<std::string, LockStats> get_stats() {
+  std::map<std::string, LockStats> res;
+  const std::lock_guard lock(stats_mutex);
+  for (const auto& [name, stats] : stats_by_name) {
+    auto& lock_stats = res[name];
+    lock_stats.acquisitions = stats->acquisitions;
+    lock_stats.contended_acquisitions = stats->contended_acquisitions;
+    lock_stats.wait_nanoseconds = stats->wait_nanoseconds;
+    lock_stats.max_wait_nanoseconds = stats->max_wait_nanoseconds;
+    lock_stats.hold_nanoseconds = stats->hold_nanoseconds;
+    lock_stats.max_hold_nanoseconds = stats->max_hold_nanoseconds;
+  }
+  return res;
+}
+
+}  // namespace lock_profiling
+
+ProfiledMutex::ProfiledMutex(const char* name)
+    : stats_([name]() -> Stats& {
+        const std::lock_guard lock(stats_mutex);
+        auto& stats = stats_by_name[name];
+        if (!stats)
+          stats = std::make_unique<Stats>();
+        return *stats;
+      }()) {}
+
+void ProfiledMutex::lock() {
+  if (!lock_profiling::is_enabled()) {
+    mutex_.lock();
+    locked_timestamp_ = -1;
+    return;
+  }
+  const int64_t start_timestamp = get_timestamp();
+  if (!mutex_.try_lock()) {
+    stats_.contended_acquisitions++;
+    mutex_.lock();
+  }
+  locked_timestamp_ = get_timestamp();
+  const uint64_t wait_nanoseconds = locked_timestamp_ - start_timestamp;
+  stats_.acquisitions++;
+  stats_.wait_nanoseconds += wait_nanoseconds;
+  update_max(stats_.max_wait_nanoseconds, wait_nanoseconds);
+}
+
+bool ProfiledMutex::try_lock() {
+  if (!mutex_.try_lock())
+    return false;
+  locked_timestamp_ = -1;
+  if (lock_profiling::is_enabled()) {
+    locked_timestamp_ = get_timestamp();
+    stats_.acquisitions++;
+  }
+  return true;
+}
+
+void ProfiledMutex::unlock() {
+  if (locked_timestamp_ >= 0) {
+    const uint64_t hold_nanoseconds = get_timestamp() - locked_timestamp_;
+    stats_.hold_nanoseconds += hold_nanoseconds;
+    update_max(stats_.max_hold_nanoseconds, hold_nanoseconds);
+  }
+  mutex_.unlock();
+}
+
+}  // namespace uni_cpp_practice
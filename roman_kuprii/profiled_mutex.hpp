@@ -0,0 +1,62 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+
+namespace uni_cpp_practice {
+
+namespace lock_profiling {
+
+struct LockStats {
+  uint64_t acquisitions = 0;
+  // acquisitions that found the lock taken
+  uint64_t contended_acquisitions = 0;
+  uint64_t wait_nanoseconds = 0;
+  uint64_t max_wait_nanoseconds = 0;
+  uint64_t hold_nanoseconds = 0;
+  uint64_t max_hold_nanoseconds = 0;
+};
+
+// locks are timed only while profiling is enabled, it is off by default
+void set_enabled(bool is_enabled);
+bool is_enabled();
+
+// stats of every lock name so far, mutexes sharing a name add up
+std::map<std::string, LockStats> get_stats();
+
+}  // namespace lock_profiling
+
+// std::mutex that counts its acquisitions and times waiting for it and
+// holding it under its name, works with std::lock_guard and std::unique_lock
+class ProfiledMutex {
+ public:
+  // name must outlive the mutex, so string literals are expected
+  explicit ProfiledMutex(const char* name);
+
+  ProfiledMutex(const ProfiledMutex&) = delete;
+  ProfiledMutex& operator=(const ProfiledMutex&) = delete;
+
+  void lock();
+  bool try_lock();
+  void unlock();
+
+  struct Stats {
+    std::atomic<uint64_t> acquisitions = 0;
+    std::atomic<uint64_t> contended_acquisitions = 0;
+    std::atomic<uint64_t> wait_nanoseconds = 0;
+    std::atomic<uint64_t> max_wait_nanoseconds = 0;
+    std::atomic<uint64_t> hold_nanoseconds = 0;
+    std::atomic<uint64_t> max_hold_nanoseconds = 0;
+  };
+
+ private:
+  std::mutex mutex_;
+  Stats& stats_;
+  // start of the current hold, written by the owner only, -1 when untimed
+  int64_t locked_timestamp_ = -1;
+};
+
+}  // namespace uni_cpp_practice
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <type_traits>
+
+namespace uni_cpp_practice {
+
+// vector that keeps up to InlineCapacity elements inside the object itself
+// and moves them to the heap only when it grows beyond that
+template <typename T, int InlineCapacity>
+class SmallVector {
+  static_assert(std::is_trivially_copyable_v<T>,
+                "SmallVector only stores trivially copyable elements");
+
+ public:
+  SmallVector() = default;
+
+  SmallVector(const SmallVector& other) { copy_from(other); }
+
+  SmallVector(SmallVector&& other) noexcept { move_from(other); }
+
+  SmallVector& operator=(const SmallVector& other) {
+    if (this != &other) {
+      release();
+      copy_from(other);
+    }
+    return *this;
+  }
+
+  SmallVector& operator=(SmallVector&& other) noexcept {
+    if (this != &other) {
+      release();
+      move_from(other);
+    }
+    return *this;
+  }
+
+  ~SmallVector() { release(); }
+
+  void push_back(const T& value) {
+    if (size_ == capacity_)
+      reserve(capacity_ * 2);
+    data_[size_++] = value;
+  }
+
+  void reserve(int capacity) {
+    if (capacity <= capacity_)
+      return;
+    T* new_data = new T[capacity];
+    std::copy(data_, data_ + size_, new_data);
+    const int size = size_;
+    release();
+    data_ = new_data;
+    capacity_ = capacity;
+    size_ = size;
+  }
+
+  const T& operator[](int index) const {
+    assert(index < size_);
+    return data_[index];
+  }
+
+  const T& back() const {
+    assert(size_ > 0);
+    return data_[size_ - 1];
+  }
+
+  const T* begin() const { return data_; }
+  const T* end() const { return data_ + size_; }
+
+  int size() const { return size_; }
+  bool empty() const { return size_ == 0; }
+  int capacity() const { return capacity_; }
+  bool is_inline() const { return data_ == inline_data_; }
+
+ private:
+  T* data_ = inline_data_;
+  int size_ = 0;
+  int capacity_ = InlineCapacity;
+  T inline_data_[InlineCapacity];
+
+  // leaves an empty inline vector
+  void release() {
+    if (!is_inline())
+      delete[] data_;
+    data_ = inline_data_;
+    size_ = 0;
+    capacity_ = InlineCapacity;
+  }
+
+  void copy_from(const SmallVector& other) {
+    reserve(other.size_);
+    std::copy(other.begin(), other.end(), data_);
+    size_ = other.size_;
+  }
+
+  void move_from(SmallVector& other) {
+    if (other.is_inline()) {
+      std::copy(other.begin(), other.end(), inline_data_);
+    } else {
+      data_ = other.data_;
+      capacity_ = other.capacity_;
+      other.data_ = other.inline_data_;
+      other.capacity_ = InlineCapacity;
+    }
+    size_ = other.size_;
+    other.size_ = 0;
+  }
+};
+
+}  // namespace uni_cpp_practice
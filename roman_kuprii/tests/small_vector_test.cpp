@@ -0,0 +1,105 @@
+// checks of SmallVector, run with `make test`; exits with 0 when all pass
+#undef NDEBUG
+
+#include <cassert>
+#include <iostream>
+#include <utility>
+
+#include "../small_vector.hpp"
+
+namespace {
+
+constexpr int INLINE_CAPACITY = 4;
+
+using SmallVector = uni_cpp_practice::SmallVector<int, INLINE_CAPACITY>;
+
+SmallVector make_vector(int size) {
+  SmallVector res;
+  for (int i = 0; i < size; i++)
+    res.push_back(i * 10);
+  return res;
+}
+
+void assert_holds(const SmallVector& vector, int size) {
+  assert(vector.size() == size);
+  assert(vector.capacity() >= size);
+  assert(vector.is_inline() == (vector.capacity() == INLINE_CAPACITY));
+  for (int i = 0; i < size; i++)
+    assert(vector[i] == i * 10);
+}
+
+void test_push_back_spills() {
+  auto vector = make_vector(INLINE_CAPACITY);
+  assert(vector.is_inline());
+  vector.push_back(INLINE_CAPACITY * 10);
+  assert(!vector.is_inline());
+  assert_holds(vector, INLINE_CAPACITY + 1);
+}
+
+void test_copy_assign_spilled_into_inline() {
+  const auto spilled = make_vector(INLINE_CAPACITY * 4);
+  auto vector = make_vector(2);
+  vector = spilled;
+  assert_holds(vector, INLINE_CAPACITY * 4);
+  assert_holds(spilled, INLINE_CAPACITY * 4);
+}
+
+void test_copy_assign_inline_into_spilled() {
+  const auto small = make_vector(2);
+  auto vector = make_vector(INLINE_CAPACITY * 4);
+  vector = small;
+  assert_holds(vector, 2);
+  assert(vector.is_inline());
+}
+
+void test_copy_assign_spilled_into_spilled() {
+  const auto larger = make_vector(INLINE_CAPACITY * 8);
+  const auto smaller = make_vector(INLINE_CAPACITY * 2);
+  auto vector = make_vector(INLINE_CAPACITY * 4);
+  vector = larger;
+  assert_holds(vector, INLINE_CAPACITY * 8);
+  vector = smaller;
+  assert_holds(vector, INLINE_CAPACITY * 2);
+}
+
+void test_self_assign() {
+  auto vector = make_vector(INLINE_CAPACITY * 2);
+  const auto& same_vector = vector;
+  vector = same_vector;
+  assert_holds(vector, INLINE_CAPACITY * 2);
+}
+
+void test_copy_and_move_construct() {
+  const auto spilled = make_vector(INLINE_CAPACITY * 2);
+  auto copy = spilled;
+  assert_holds(copy, INLINE_CAPACITY * 2);
+  const auto moved = std::move(copy);
+  assert_holds(moved, INLINE_CAPACITY * 2);
+  assert(copy.empty());
+}
+
+void test_move_assign() {
+  auto spilled = make_vector(INLINE_CAPACITY * 2);
+  auto vector = make_vector(INLINE_CAPACITY * 3);
+  vector = std::move(spilled);
+  assert_holds(vector, INLINE_CAPACITY * 2);
+  assert(spilled.empty());
+
+  auto small = make_vector(2);
+  vector = std::move(small);
+  assert_holds(vector, 2);
+}
+
+}  // namespace
+
+int main() {
+  test_push_back_spills();
+  test_copy_assign_spilled_into_inline();
+  test_copy_assign_inline_into_spilled();
+  test_copy_assign_spilled_into_spilled();
+  test_self_assign();
+  test_copy_and_move_construct();
+  test_move_assign();
+  std::cout << "small_vector_test: ok" << std::endl;
+  return 0;
+}
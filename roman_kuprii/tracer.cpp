@@ -0,0 +1,135 @@
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "tracer.hpp"
+
+namespace uni_cpp_practice {
+
+namespace tracer {
+
+namespace {
+
+struct Event {
+  const char* name = nullptr;
+  const char* category = nullptr;
+  int64_t start_timestamp = 0;
+  int64_t end_timestamp = 0;
+  int graph_num = -1;
+};
+
+// written by its own thread only, the lock is taken by the dump as well
+struct ThreadBuffer {
+  explicit ThreadBuffer(int _thread_id) : thread_id(_thread_id) {}
+
+  const int thread_id;
+  std::mutex mutex;
+  std::vector<Event> events;
+};
+
+std::atomic<bool> is_tracing_enabled = false;
+
+// buffers of finished threads stay here until the dump
+std::mutex buffers_mutex;
+std::list<std::shared_ptr<ThreadBuffer>> buffers;
+
+ThreadBuffer& get_thread_buffer() {
+  thread_local const std::shared_ptr<ThreadBuffer> thread_buffer = []() {
+    const std::lock_guard lock(buffers_mutex);
+    const int thread_id = buffers.size() + 1;
+    return buffers.emplace_back(std::make_shared<ThreadBuffer>(thread_id));
+  }();
+  return *thread_buffer;
+}
+
+const std::chrono::steady_clock::time_point& get_start_time() {
+  static const auto start_time = std::chrono::steady_clock::now();
+  return start_time;
+}
+
+std::string to_microseconds(int64_t nanoseconds) {
+  std::stringstream microseconds;
+  microseconds << std::fixed << std::setprecision(3)
+               << static_cast<double>(nanoseconds) / 1000;
+  return microseconds.str();
+}
+
+std::string event_to_json(const Event& event, int thread_id) {
+  std::string res = "{\"name\": \"";
+  res += event.name;
+  res += "\", \"cat\": \"";
+  res += event.category;
+  res += "\", \"ph\": \"X\", \"pid\": 1, \"tid\": " + std::to_string(thread_id);
+  res += ", \"ts\": " + to_microseconds(event.start_timestamp);
+  res += ", \"dur\": " +
+         to_microseconds(event.end_timestamp - event.start_timestamp);
+  if (event.graph_num >= 0)
+    res += ", \"args\": {\"graph\": " + std::to_string(event.graph_num) + "}";
+  res += "}";
+  return res;
+}
+
+}  // namespace
+
+void set_enabled(bool is_enabled) {
+  // fixes the time origin before the first event
+  get_start_time();
+  is_tracing_enabled = is_enabled;
+}
+
+bool is_enabled() {
+  return is_tracing_enabled.load(std::memory_order_relaxed);
+}
+
+int64_t get_timestamp() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now() - get_start_time())
+      .count();
+}
+
+void record_event(const char* name,
+                  const char* category,
+                  int64_t start_timestamp,
+                  int64_t end_timestamp,
+                  int graph_num) {
+  auto& thread_buffer = get_thread_buffer();
+  const std::lock_guard lock(thread_buffer.mutex);
+  thread_buffer.events.push_back(
+      {name, category, start_timestamp, end_timestamp, graph_num});
+}
+
+std::string to_chrome_json() {
+  std::string res = "{\"traceEvents\": [\n";
+  bool is_first = true;
+  const std::lock_guard buffers_lock(buffers_mutex);
+  for (const auto& thread_buffer : buffers) {
+    const std::lock_guard lock(thread_buffer->mutex);
+    for (const auto& event : thread_buffer->events) {
+      if (!is_first)
+        res += ",\n";
+      is_first = false;
+      res += "  " + event_to_json(event, thread_buffer->thread_id);
+    }
+  }
+  res += "\n], \"displayTimeUnit\": \"ms\"}\n";
+  return res;
+}
+
+void write_chrome_trace(const std::string& filename) {
+  std::ofstream out;
+  out.open(filename, std::ofstream::out | std::ofstream::trunc);
+  out << to_chrome_json();
+  out.close();
+}
+
+}  // namespace tracer
+
+}  // namespace uni_cpp_practice
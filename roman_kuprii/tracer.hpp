@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+namespace uni_cpp_practice {
+
+namespace tracer {
+
+// events are recorded only while the tracer is enabled, it is off by default
+void set_enabled(bool is_enabled);
+bool is_enabled();
+
+// nanoseconds since the tracer was first used
+int64_t get_timestamp();
+
+// appends a finished event to the buffer of the calling thread, names must
+// outlive the tracer, so string literals are expected
+void record_event(const char* name,
+                  const char* category,
+                  int64_t start_timestamp,
+                  int64_t end_timestamp,
+                  int graph_num);
+
+// events of all threads so far in chrome trace event format, for
+// chrome://tracing and Perfetto
+std::string to_chrome_json();
+void write_chrome_trace(const std::string& filename);
+
+// records the lifetime of the scope as one event, graph_num is added to the
+// event arguments unless it is negative
+class ScopedEvent {
+ public:
+  ScopedEvent(const char* name, const char* category, int graph_num = -1)
+      : name_(name),
+        category_(category),
+        graph_num_(graph_num),
+        start_timestamp_(is_enabled() ? get_timestamp() : -1) {}
+
+  ScopedEvent(const ScopedEvent&) = delete;
+  ScopedEvent& operator=(const ScopedEvent&) = delete;
+
+  ~ScopedEvent() {
+    if (start_timestamp_ >= 0)
+      record_event(name_, category_, start_timestamp_, get_timestamp(),
+                   graph_num_);
+  }
+
+ private:
+  const char* const name_;
+  const char* const category_;
+  const int graph_num_;
+  const int64_t start_timestamp_;
+};
+
+}  // namespace tracer
+
+}  // namespace uni_cpp_practice
@@ -1,3 +1,4 @@
+#include <cassert>
 #include <fstream>
 #include <iostream>
 #include <sstream>
@@ -85,12 +86,12 @@ EdgeId Graph::get_new_edge_id() {
 }
 
 Vertex& Graph::get_vertex(const VertexId& id) {
-  for (auto& vertex : vertices_) {
-    if (vertex.get_id() == id) {
-      return vertex;
-    }
+  // ids are dense counters, so a vertex is stored at the index of its id
+  if (id < 0 || id >= static_cast<VertexId>(vertices_.size())) {
+    throw std::runtime_error("Vertex not found!\n");
   }
-  throw std::runtime_error("Vertex not found!\n");
+  assert(vertices_[id].get_id() == id && "Vertex is stored out of order!");
+  return vertices_[id];
 }
 
 const std::vector<EdgeId>& Vertex::get_connected_edge_ids() const {
@@ -41,11 +41,8 @@ std::string color_to_string(const Edge::Color& color) {
 }
 
 bool Graph::does_vertex_exist(const VertexId& id) const {
-  for (const auto& vertex : vertices_)
-    if (vertex.id == id) {
-      return true;
-    }
-  return false;
+  // ids are dense counters, so a vertex is stored at the index of its id
+  return id >= 0 && id < static_cast<VertexId>(vertices_.size());
 }
 
 VertexId Graph::insert_vertex() {
@@ -83,19 +80,17 @@ Edge::Color Graph::calculate_color_for_edge(const Vertex& source,
 }
 
 const Vertex& Graph::get_vertex(const VertexId& id) const {
-  for (auto& vertex : vertices_) {
-    if (id == vertex.id)
-      return vertex;
-  }
-  throw std::runtime_error("Vertex not found!");
+  if (!does_vertex_exist(id))
+    throw std::runtime_error("Vertex not found!");
+  assert(vertices_[id].id == id && "Vertex is stored out of order!");
+  return vertices_[id];
 }
 
 const Edge& Graph::get_edge(const EdgeId& id) const {
-  for (auto& edge : edges_) {
-    if (id == edge.id)
-      return edge;
-  }
-  throw std::runtime_error("Edge not found!");
+  if (id < 0 || id >= static_cast<EdgeId>(edges_.size()))
+    throw std::runtime_error("Edge not found!");
+  assert(edges_[id].id == id && "Edge is stored out of order!");
+  return edges_[id];
 }
 
 void Graph::insert_edge(const VertexId& source_id,